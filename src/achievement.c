@@ -17,8 +17,15 @@
  */
 
 #include "achievement.h"
+#include "memtrack.h"
+#include "writer.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#define ACHIEVEMENT_MAGIC "CACH"
+#define ACHIEVEMENT_FORMAT_VERSION 1
+// Field ids; never reuse a retired one.
+#define ACHIEVEMENT_FIELD_UNLOCKED 1 // repeated, one per unlocked id
 static const char *achievementNames[MAX_ACHIEVEMENTS] = {
     "Stage 1 Complete", "Stage 2 Complete", "Stage 3 Complete",
     "Stage 4 Complete", "Stage 5 Complete", "Stage 6 Complete",
@@ -70,39 +77,73 @@ void Achievement_FixPointers(AchievementSystem *sys)
 		sys->achievements[i].description = achievementDescriptions[i];
 	}
 }
-void Achievement_Load(AchievementSystem *sys)
+static void Achievement_Recount(AchievementSystem *sys)
 {
-	const char *filepath = "achievements.dat";
-	FILE *f = fopen(filepath, "rb");
-	if (f)
+	sys->unlockedCount = 0;
+	for (int i = 0; i < MAX_ACHIEVEMENTS; i++)
 	{
-		for (int i = 0; i < MAX_ACHIEVEMENTS; i++)
-		{
-			fread(&sys->achievements[i].unlocked, sizeof(bool), 1, f);
-		}
-		fclose(f);
-		sys->unlockedCount = 0;
-		for (int i = 0; i < MAX_ACHIEVEMENTS; i++)
+		if (sys->achievements[i].unlocked)
 		{
-			if (sys->achievements[i].unlocked)
-			{
-				sys->unlockedCount++;
-			}
+			sys->unlockedCount++;
 		}
 	}
 }
-void Achievement_Save(const AchievementSystem *sys)
+// Only unlocked achievements are written, by id, so adding or retiring
+// achievements does not disturb the others.
+void Achievement_Serialize(const AchievementSystem *sys, SerialWriter *w)
+{
+	for (int i = 0; i < MAX_ACHIEVEMENTS; i++)
+	{
+		if (sys->achievements[i].unlocked)
+			SerialWriter_PutInt(w, ACHIEVEMENT_FIELD_UNLOCKED, i);
+	}
+}
+void Achievement_Deserialize(AchievementSystem *sys, SerialReader *r)
+{
+	SerialField field;
+	for (int i = 0; i < MAX_ACHIEVEMENTS; i++)
+	{
+		sys->achievements[i].unlocked = false;
+	}
+	while (SerialReader_Next(r, &field))
+	{
+		int id = Serial_GetInt(&field);
+		if (field.id == ACHIEVEMENT_FIELD_UNLOCKED && id >= 0 &&
+		    id < MAX_ACHIEVEMENTS)
+			sys->achievements[id].unlocked = true;
+	}
+	Achievement_Recount(sys);
+}
+void Achievement_Load(AchievementSystem *sys)
 {
-	const char *filepath = "achievements.dat";
-	FILE *f = fopen(filepath, "wb");
-	if (f)
+	int size = 0;
+	unsigned char *data = Serial_ReadFile("achievements.dat", &size);
+	SerialReader r;
+	if (!data)
+		return;
+	if (SerialReader_Open(&r, data, size, ACHIEVEMENT_MAGIC, NULL))
+	{
+		Achievement_Deserialize(sys, &r);
+	}
+	else if (size == MAX_ACHIEVEMENTS * (int)sizeof(bool))
 	{
+		// Written before the tagged format: one bool per achievement.
 		for (int i = 0; i < MAX_ACHIEVEMENTS; i++)
 		{
-			fwrite(&sys->achievements[i].unlocked, sizeof(bool), 1, f);
+			sys->achievements[i].unlocked = data[i] != 0;
 		}
-		fclose(f);
+		Achievement_Recount(sys);
 	}
+	Mem_Free(data);
+}
+void Achievement_Save(const AchievementSystem *sys)
+{
+	SerialWriter w;
+	SerialWriter_Begin(&w, ACHIEVEMENT_MAGIC, ACHIEVEMENT_FORMAT_VERSION);
+	Achievement_Serialize(sys, &w);
+	if (!w.failed)
+		Writer_Submit("achievements.dat", w.data, w.size);
+	SerialWriter_Free(&w);
 }
 bool Achievement_Unlock(AchievementSystem *sys, AchievementID id)
 {
@@ -1,6 +1,7 @@
 #ifndef ACHIEVEMENT_H
 #define ACHIEVEMENT_H
 #include "config.h"
+#include "serial.h"
 #include <stdbool.h>
 #define MAX_ACHIEVEMENTS 19
 typedef enum
@@ -44,6 +45,8 @@ typedef struct
 void Achievement_Init(AchievementSystem *sys);
 void Achievement_Load(AchievementSystem *sys);
 void Achievement_Save(const AchievementSystem *sys);
+void Achievement_Serialize(const AchievementSystem *sys, SerialWriter *w);
+void Achievement_Deserialize(AchievementSystem *sys, SerialReader *r);
 bool Achievement_Unlock(AchievementSystem *sys, AchievementID id);
 void Achievement_FixPointers(AchievementSystem *sys);
 bool Achievement_IsUnlocked(const AchievementSystem *sys, AchievementID id);
@@ -17,127 +17,229 @@
  */
 
 #include "assets.h"
+#include "atlas.h"
+#include "cache.h"
 #include "config.h"
+#include "pack.h"
 #include <stdio.h>
 #include <string.h>
-void Assets_Load(Assets *assets)
+// Picks the .wav or .ogg variant of a sound; if neither exists the cache
+// hands out a silent placeholder for the .wav path.
+static void Assets_FindSound(char *path, const char *base)
 {
-	assets->tileSize = 50;
-	assets->musicFileCount = 0;
-	if (FileExists("assets/tiles/tileset.png"))
-	{
-		assets->tileset = LoadTexture("assets/tiles/tileset.png");
-	}
-	else
-	{
-		Image img = GenImageColor(250, 50, BLANK);
-		ImageDrawRectangle(&img, 0, 0, 50, 50, GREEN);
-		ImageDrawRectangle(&img, 0, 40, 50, 10, DARKGREEN);
-		ImageDrawRectangle(&img, 50, 0, 50, 50, (Color){139, 69, 19, 255});
-		ImageDrawRectangle(&img, 100, 0, 50, 50, GRAY);
-		ImageDrawRectangle(&img, 105, 5, 15, 15, DARKGRAY);
-		ImageDrawRectangle(&img, 130, 25, 12, 12, DARKGRAY);
-		ImageDrawRectangle(&img, 150, 0, 50, 50, GOLD);
-		ImageDrawRectangle(&img, 160, 10, 30, 30, YELLOW);
-		assets->tileset = LoadTextureFromImage(img);
-		UnloadImage(img);
-	}
-	if (FileExists("assets/sounds/jump.wav"))
-	{
-		assets->jumpSound = LoadSound("assets/sounds/jump.wav");
-	}
-	else if (FileExists("assets/sounds/jump.ogg"))
-	{
-		assets->jumpSound = LoadSound("assets/sounds/jump.ogg");
-	}
-	else
-	{
-		Wave wave = {0};
-		wave.frameCount = 4000;
-		wave.sampleRate = 44100;
-		wave.sampleSize = 16;
-		wave.channels = 1;
-		assets->jumpSound = LoadSoundFromWave(wave);
-	}
-	if (FileExists("assets/sounds/complete.wav"))
-	{
-		assets->levelCompleteSound = LoadSound("assets/sounds/complete.wav");
-	}
-	else if (FileExists("assets/sounds/complete.ogg"))
-	{
-		assets->levelCompleteSound = LoadSound("assets/sounds/complete.ogg");
-	}
-	else
+	snprintf(path, 256, "%s.wav", base);
+	if (!Pack_Exists(path) && Pack_Exists(TextFormat("%s.ogg", base)))
+		snprintf(path, 256, "%s.ogg", base);
+}
+// The tracks on disk and in the pack, listed once rather than on every
+// level load; Assets_Load hands each world a copy.
+static MusicFile musicList[MAX_MUSIC_FILES];
+static int musicListCount = 0;
+static bool musicListed = false;
+
+static void Assets_AddMusicFile(const char *path)
+{
+	const char *ext = GetFileExtension(path);
+	if (musicListCount >= MAX_MUSIC_FILES ||
+	    !(TextIsEqual(ext, ".ogg") || TextIsEqual(ext, ".mp3") ||
+	      TextIsEqual(ext, ".wav")))
+		return;
+	for (int i = 0; i < musicListCount; i++)
 	{
-		Wave wave = {0};
-		wave.frameCount = 8000;
-		wave.sampleRate = 44100;
-		wave.sampleSize = 16;
-		wave.channels = 1;
-		assets->levelCompleteSound = LoadSoundFromWave(wave);
+		if (strcmp(musicList[i].filename, GetFileName(path)) == 0)
+			return;
 	}
+	MusicFile *file = &musicList[musicListCount++];
+	strncpy(file->filename, GetFileName(path), 255);
+	file->filename[255] = '\0';
+	strncpy(file->path, path, 255);
+	file->path[255] = '\0';
+}
+// Only the names are collected here; a track's decoder is opened when it
+// is played or prefetched.
+static void Assets_ListMusic(void)
+{
 	FilePathList musicFiles = LoadDirectoryFiles("assets/music");
-	for (unsigned int i = 0;
-	     i < musicFiles.count && assets->musicFileCount < MAX_MUSIC_FILES; i++)
+	for (unsigned int i = 0; i < musicFiles.count; i++)
 	{
-		const char *ext = GetFileExtension(musicFiles.paths[i]);
-		if (TextIsEqual(ext, ".ogg") || TextIsEqual(ext, ".mp3") ||
-		    TextIsEqual(ext, ".wav"))
-		{
-			strncpy(assets->musicFiles[assets->musicFileCount].filename,
-			        GetFileName(musicFiles.paths[i]), 255);
-			assets->musicFiles[assets->musicFileCount].filename[255] = '\0';
-			assets->musicFiles[assets->musicFileCount].music =
-			    LoadMusicStream(musicFiles.paths[i]);
-			assets->musicFileCount++;
-		}
+		Assets_AddMusicFile(musicFiles.paths[i]);
 	}
 	UnloadDirectoryFiles(musicFiles);
+	for (int i = 0; i < Pack_GetCount(); i++)
+	{
+		const char *name = Pack_GetName(i);
+		if (TextIsEqual(GetDirectoryPath(name), "assets/music"))
+			Assets_AddMusicFile(name);
+	}
+	musicListed = true;
+}
+// Starts decoding the shared sounds in the background at startup, so the
+// first Assets_Load only has to pick them up.
+void Assets_Preload(void)
+{
+	if (!musicListed)
+		Assets_ListMusic();
+	char path[256];
+	Assets_FindSound(path, "assets/sounds/jump");
+	AssetCache_PrefetchSound(path, ASSET_LIFETIME_PERSISTENT, MEM_TAG_ASSETS);
+	Assets_FindSound(path, "assets/sounds/complete");
+	AssetCache_PrefetchSound(path, ASSET_LIFETIME_PERSISTENT, MEM_TAG_ASSETS);
+}
+void Assets_Load(Assets *assets)
+{
+	assets->tileSize = 50;
+	// The tileset lives in the shared atlas built at startup.
+	assets->tileset = Atlas_GetTexture();
+	// Every level shares these, so they stay loaded across level changes.
+	Assets_FindSound(assets->jumpSoundPath, "assets/sounds/jump");
+	assets->jumpSound = AssetCache_AcquireSound(
+	    assets->jumpSoundPath, ASSET_LIFETIME_PERSISTENT, MEM_TAG_ASSETS);
+	Assets_FindSound(assets->levelCompleteSoundPath, "assets/sounds/complete");
+	assets->levelCompleteSound =
+	    AssetCache_AcquireSound(assets->levelCompleteSoundPath,
+	                            ASSET_LIFETIME_PERSISTENT, MEM_TAG_ASSETS);
+	// Tools load worlds without Assets_Preload, so list on first use too.
+	if (!musicListed)
+		Assets_ListMusic();
+	memcpy(assets->musicFiles, musicList, sizeof(MusicFile) * musicListCount);
+	assets->musicFileCount = musicListCount;
 }
 void Assets_Unload(Assets *assets)
 {
-	UnloadTexture(assets->tileset);
-	UnloadSound(assets->jumpSound);
-	UnloadSound(assets->levelCompleteSound);
-	for (int i = 0; i < assets->musicFileCount; i++)
-	{
-		UnloadMusicStream(assets->musicFiles[i].music);
-	}
+	AssetCache_Release(assets->jumpSoundPath);
+	AssetCache_Release(assets->levelCompleteSoundPath);
 	assets->musicFileCount = 0;
 }
 Rectangle Assets_GetTileSource(int tileType)
 {
-	if (tileType < 0)
-		return (Rectangle){0, 0, 0, 0};
-	int tilesPerRow = 20;
-	int col = tileType % tilesPerRow;
-	int row = tileType / tilesPerRow;
-	return (Rectangle){col * 50.0f, row * 50.0f, 50, 50};
+	return Atlas_GetTileSource(tileType);
 }
-void Assets_PlayMusic(Assets *assets, const char *filename)
+// Music is a single player shared by every Assets instance, since only one
+// track is ever audible. It keeps its own cache references, so the track
+// keeps playing (and fading) while a world is unloaded and the next one
+// is loaded.
+typedef struct
+{
+	bool active;
+	char path[256];
+	Music music;
+	float volume;
+} MusicVoice;
+
+static MusicVoice currentTrack = {0};
+static MusicVoice fadingTrack = {0};
+static MusicVoice prefetchTrack = {0};
+
+static const char *Assets_FindMusicPath(const Assets *assets,
+                                        const char *filename)
 {
-	Assets_StopMusic(assets);
 	for (int i = 0; i < assets->musicFileCount; i++)
 	{
 		if (strcmp(assets->musicFiles[i].filename, filename) == 0)
 		{
-			PlayMusicStream(assets->musicFiles[i].music);
-			return;
+			return assets->musicFiles[i].path;
 		}
 	}
+	return NULL;
 }
-void Assets_StopMusic(Assets *assets)
+static void Assets_ReleaseVoice(MusicVoice *voice)
 {
-	for (int i = 0; i < assets->musicFileCount; i++)
+	if (!voice->active)
+		return;
+	StopMusicStream(voice->music);
+	AssetCache_Release(voice->path);
+	voice->active = false;
+}
+static bool Assets_OpenVoice(MusicVoice *voice, const char *path)
+{
+	voice->music =
+	    AssetCache_AcquireMusic(path, ASSET_LIFETIME_LEVEL, MEM_TAG_ASSETS);
+	if (voice->music.stream.buffer == NULL)
+		return false;
+	strncpy(voice->path, path, 255);
+	voice->path[255] = '\0';
+	voice->volume = 0.0f;
+	voice->active = true;
+	return true;
+}
+// Starting the track that is already playing leaves it alone; anything
+// else fades the old track out while the new one fades in.
+void Assets_PlayMusic(Assets *assets, const char *filename)
+{
+	const char *path = Assets_FindMusicPath(assets, filename);
+	if (!path)
+	{
+		Assets_StopMusic(assets);
+		return;
+	}
+	if (currentTrack.active && strcmp(currentTrack.path, path) == 0)
+		return;
+	Assets_ReleaseVoice(&fadingTrack);
+	fadingTrack = currentTrack;
+	currentTrack.active = false;
+	if (prefetchTrack.active && strcmp(prefetchTrack.path, path) == 0)
+	{
+		currentTrack = prefetchTrack;
+		prefetchTrack.active = false;
+	}
+	else if (!Assets_OpenVoice(&currentTrack, path))
 	{
-		StopMusicStream(assets->musicFiles[i].music);
+		return;
 	}
+	if (!fadingTrack.active)
+		currentTrack.volume = 1.0f;
+	SetMusicVolume(currentTrack.music, currentTrack.volume);
+	PlayMusicStream(currentTrack.music);
 }
-void Assets_UpdateMusic(Assets *assets)
+// Opens the decoder for a track that is about to be needed, so the next
+// Assets_PlayMusic does not have to touch the disk.
+void Assets_PrefetchMusic(Assets *assets, const char *filename)
 {
-	for (int i = 0; i < assets->musicFileCount; i++)
+	const char *path = Assets_FindMusicPath(assets, filename);
+	if (!path)
+		return;
+	if (currentTrack.active && strcmp(currentTrack.path, path) == 0)
+		return;
+	if (prefetchTrack.active)
+	{
+		if (strcmp(prefetchTrack.path, path) == 0)
+			return;
+		Assets_ReleaseVoice(&prefetchTrack);
+	}
+	Assets_OpenVoice(&prefetchTrack, path);
+}
+void Assets_StopMusic(Assets *assets)
+{
+	Assets_ReleaseVoice(&currentTrack);
+	Assets_ReleaseVoice(&fadingTrack);
+	Assets_ReleaseVoice(&prefetchTrack);
+}
+void Assets_UpdateMusic(float dt)
+{
+	float step = dt / MUSIC_CROSSFADE_TIME;
+	if (fadingTrack.active)
 	{
-		UpdateMusicStream(assets->musicFiles[i].music);
+		fadingTrack.volume -= step;
+		if (fadingTrack.volume <= 0.0f)
+		{
+			Assets_ReleaseVoice(&fadingTrack);
+		}
+		else
+		{
+			SetMusicVolume(fadingTrack.music, fadingTrack.volume);
+			UpdateMusicStream(fadingTrack.music);
+		}
+	}
+	if (currentTrack.active)
+	{
+		if (currentTrack.volume < 1.0f)
+		{
+			currentTrack.volume += step;
+			if (currentTrack.volume > 1.0f)
+				currentTrack.volume = 1.0f;
+			SetMusicVolume(currentTrack.music, currentTrack.volume);
+		}
+		UpdateMusicStream(currentTrack.music);
 	}
 }
 void Assets_PlayJumpSound(Assets *assets) { PlaySound(assets->jumpSound); }
@@ -5,7 +5,7 @@
 typedef struct
 {
 	char filename[256];
-	Music music;
+	char path[256];
 } MusicFile;
 typedef struct
 {
@@ -13,16 +13,25 @@ typedef struct
 	int tileSize;
 	Sound jumpSound;
 	Sound levelCompleteSound;
+	char jumpSoundPath[256];
+	char levelCompleteSoundPath[256];
 	MusicFile musicFiles[MAX_MUSIC_FILES];
 	int musicFileCount;
 } Assets;
+void Assets_Preload(void);
 void Assets_Load(Assets *assets);
 void Assets_Unload(Assets *assets);
 Rectangle Assets_GetTileSource(int tileType);
 void Assets_PlayMusic(Assets *assets, const char *filename);
+void Assets_PrefetchMusic(Assets *assets, const char *filename);
 void Assets_StopMusic(Assets *assets);
-void Assets_UpdateMusic(Assets *assets);
+void Assets_UpdateMusic(float dt);
+#ifdef CIRNO_HEADLESS
+// The simulation library has no audio device.
+#define Assets_PlayJumpSound(assets) ((void)(assets))
+#else
 void Assets_PlayJumpSound(Assets *assets);
+#endif
 void Assets_PlayLevelCompleteSound(Assets *assets);
 int Assets_GetMusicCount(const Assets *assets);
 const char *Assets_GetMusicFilename(const Assets *assets, int index);
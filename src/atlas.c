@@ -0,0 +1,355 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "atlas.h"
+#include "config.h"
+#include "memtrack.h"
+#include "pack.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Everything the world draws lives in one texture so a frame of tiles,
+// bullets, pickups and the player goes out without texture rebinds. The
+// source rectangles below are the UV lookup tables into that texture.
+#define ATLAS_MAX_ENTRIES (ATLAS_MAX_TILES * 2 + ATLAS_SPRITE_COUNT + 1)
+#define ATLAS_TILESET_COLUMNS 20
+#define ATLAS_BULLET_SIZE 32
+#define ATLAS_ICON_SIZE 80
+
+typedef struct
+{
+	Image image;      // image the entry is copied from (not owned)
+	Rectangle source; // region of that image
+	Rectangle *out;   // receives the packed rectangle
+} AtlasEntry;
+
+static Texture2D atlasTexture = {0};
+static bool atlasBuilt = false;
+static Rectangle tileSources[ATLAS_MAX_TILES];
+static Rectangle backgroundTileSources[ATLAS_MAX_TILES];
+static Rectangle spriteSources[ATLAS_SPRITE_COUNT];
+static Rectangle playerSheet = {0};
+
+static AtlasEntry entries[ATLAS_MAX_ENTRIES];
+static int entryCount = 0;
+static Image bakedImages[ATLAS_MAX_ENTRIES];
+static int bakedCount = 0;
+
+static void Atlas_AddEntry(Image image, Rectangle source, Rectangle *out)
+{
+	if (entryCount >= ATLAS_MAX_ENTRIES)
+		return;
+	entries[entryCount].image = image;
+	entries[entryCount].source = source;
+	entries[entryCount].out = out;
+	entryCount++;
+}
+static void Atlas_AddBaked(Image image, Rectangle *out)
+{
+	if (bakedCount >= ATLAS_MAX_ENTRIES)
+	{
+		UnloadImage(image);
+		return;
+	}
+	bakedImages[bakedCount++] = image;
+	Atlas_AddEntry(image, (Rectangle){0, 0, image.width, image.height}, out);
+}
+static Image Atlas_LoadTileset(void)
+{
+	if (Pack_Exists(ASSET_TILESET_PATH))
+	{
+		Image img = LoadImage(ASSET_TILESET_PATH);
+		ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+		return img;
+	}
+	Image img = GenImageColor(250, 50, BLANK);
+	ImageDrawRectangle(&img, 0, 0, 50, 50, GREEN);
+	ImageDrawRectangle(&img, 0, 40, 50, 10, DARKGREEN);
+	ImageDrawRectangle(&img, 50, 0, 50, 50, (Color){139, 69, 19, 255});
+	ImageDrawRectangle(&img, 100, 0, 50, 50, GRAY);
+	ImageDrawRectangle(&img, 105, 5, 15, 15, DARKGRAY);
+	ImageDrawRectangle(&img, 130, 25, 12, 12, DARKGRAY);
+	ImageDrawRectangle(&img, 150, 0, 50, 50, GOLD);
+	ImageDrawRectangle(&img, 160, 10, 30, 30, YELLOW);
+	return img;
+}
+// Special tiles used to be drawn shape by shape every frame, bake them once.
+static bool Atlas_BakeSpecialTile(int tile, Image *out)
+{
+	Color spawnerColor;
+	const char *letter;
+	switch (tile)
+	{
+	case TILE_SPAWNER_CIRCLE:
+		spawnerColor = RED;
+		letter = "C";
+		break;
+	case TILE_SPAWNER_SPIRAL:
+		spawnerColor = PURPLE;
+		letter = "S";
+		break;
+	case TILE_SPAWNER_WAVE:
+		spawnerColor = BLUE;
+		letter = "W";
+		break;
+	case TILE_SPAWNER_BURST:
+		spawnerColor = ORANGE;
+		letter = "B";
+		break;
+	case TILE_CHECKPOINT:
+		*out = GenImageColor(TILE_SIZE, TILE_SIZE, SKYBLUE);
+		ImageDrawText(out, "CP", 12, 18, 18, WHITE);
+		return true;
+	case TILE_DAMAGE:
+		*out = GenImageColor(TILE_SIZE, TILE_SIZE, ORANGE);
+		return true;
+	case TILE_SPIKE:
+		*out = GenImageColor(TILE_SIZE, TILE_SIZE, RED);
+		ImageDrawTriangle(out, (Vector2){0, TILE_SIZE},
+		                  (Vector2){TILE_SIZE / 2, 0},
+		                  (Vector2){TILE_SIZE, TILE_SIZE}, DARKGRAY);
+		return true;
+	default:
+		return false;
+	}
+	*out = GenImageColor(TILE_SIZE, TILE_SIZE, (Color){50, 50, 50, 255});
+	ImageDrawCircle(out, 25, 25, 18, spawnerColor);
+	ImageDrawText(out, letter, letter[0] == 'W' ? 19 : 20, 15, 20, WHITE);
+	return true;
+}
+static Image Atlas_BakeBackgroundTile(int tile)
+{
+	Image img = GenImageColor(TILE_SIZE, TILE_SIZE, (Color){100, 100, 150, 100});
+	ImageDrawText(&img, TextFormat("%d", tile), 5, 5, 12,
+	              (Color){255, 255, 255, 150});
+	return img;
+}
+// Pickups are baked at 4x their in-game radius so they stay smooth when
+// scaled, with the same proportions Collectible_Draw used for its circles.
+static Image Atlas_BakeCollectible(CollectibleType type)
+{
+	int c = ATLAS_ICON_SIZE / 2;
+	float scale = (ATLAS_ICON_SIZE / 2 - 1) / (HEALTH_POINT_SIZE + 2);
+	Image img = GenImageColor(ATLAS_ICON_SIZE, ATLAS_ICON_SIZE, BLANK);
+	if (type == COLLECTIBLE_HEALTH_POINT)
+	{
+		float r = HEALTH_POINT_SIZE * scale;
+		float size = r * 0.6f;
+		ImageDrawCircle(&img, c, c, (int)((HEALTH_POINT_SIZE + 2) * scale),
+		                (Color){255, 255, 255, 100});
+		ImageDrawCircle(&img, c, c, (int)r, HEALTH_POINT_COLOR);
+		ImageDrawRectangle(&img, (int)(c - size / 4), (int)(c - size),
+		                   (int)(size / 2), (int)(size * 2), WHITE);
+		ImageDrawRectangle(&img, (int)(c - size), (int)(c - size / 4),
+		                   (int)(size * 2), (int)(size / 2), WHITE);
+	}
+	else
+	{
+		scale = (ATLAS_ICON_SIZE / 2 - 1) / (SCORE_ITEM_SIZE + 2);
+		ImageDrawCircle(&img, c, c, (int)((SCORE_ITEM_SIZE + 2) * scale),
+		                (Color){255, 255, 255, 100});
+		ImageDrawCircle(&img, c, c, (int)(SCORE_ITEM_SIZE * scale),
+		                SCORE_ITEM_COLOR);
+		ImageDrawCircle(&img, c, c, (int)((SCORE_ITEM_SIZE - 2) * scale),
+		                (Color){255, 235, 100, 255});
+	}
+	return img;
+}
+static int Atlas_CompareEntries(const void *a, const void *b)
+{
+	const AtlasEntry *ea = (const AtlasEntry *)a;
+	const AtlasEntry *eb = (const AtlasEntry *)b;
+	if (ea->source.height != eb->source.height)
+		return ea->source.height > eb->source.height ? -1 : 1;
+	return ea->source.width > eb->source.width ? -1
+	       : ea->source.width < eb->source.width ? 1
+	                                             : 0;
+}
+// Copy an entry into the atlas and repeat its border pixels into the padding
+// so filtered sampling at the edge never picks up the neighbouring sprite.
+static void Atlas_Blit(Image *atlas, const AtlasEntry *e, float x, float y)
+{
+	Rectangle s = e->source;
+	ImageDraw(atlas, e->image, s, (Rectangle){x, y, s.width, s.height}, WHITE);
+	ImageDraw(atlas, e->image, (Rectangle){s.x, s.y, s.width, 1},
+	          (Rectangle){x, y - 1, s.width, 1}, WHITE);
+	ImageDraw(atlas, e->image,
+	          (Rectangle){s.x, s.y + s.height - 1, s.width, 1},
+	          (Rectangle){x, y + s.height, s.width, 1}, WHITE);
+	ImageDraw(atlas, e->image, (Rectangle){s.x, s.y, 1, s.height},
+	          (Rectangle){x - 1, y, 1, s.height}, WHITE);
+	ImageDraw(atlas, e->image,
+	          (Rectangle){s.x + s.width - 1, s.y, 1, s.height},
+	          (Rectangle){x + s.width, y, 1, s.height}, WHITE);
+}
+// Simple shelf packer: tallest first, left to right, new shelf when full.
+static void Atlas_Pack(Image *atlas)
+{
+	qsort(entries, entryCount, sizeof(AtlasEntry), Atlas_CompareEntries);
+	int x = ATLAS_PADDING;
+	int y = ATLAS_PADDING;
+	int shelfHeight = 0;
+	for (int i = 0; i < entryCount; i++)
+	{
+		int w = (int)entries[i].source.width;
+		int h = (int)entries[i].source.height;
+		if (x + w + ATLAS_PADDING > ATLAS_SIZE)
+		{
+			x = ATLAS_PADDING;
+			y += shelfHeight + ATLAS_PADDING;
+			shelfHeight = 0;
+		}
+		if (w + 2 * ATLAS_PADDING > ATLAS_SIZE ||
+		    y + h + ATLAS_PADDING > ATLAS_SIZE)
+		{
+			TraceLog(LOG_WARNING, "ATLAS: No room for %dx%d sprite", w, h);
+			continue;
+		}
+		Atlas_Blit(atlas, &entries[i], (float)x, (float)y);
+		*entries[i].out = (Rectangle){(float)x, (float)y, (float)w, (float)h};
+		x += w + ATLAS_PADDING;
+		if (h > shelfHeight)
+			shelfHeight = h;
+	}
+}
+void Atlas_Build(void)
+{
+	if (atlasBuilt)
+		Atlas_Unload();
+	memset(tileSources, 0, sizeof(tileSources));
+	memset(backgroundTileSources, 0, sizeof(backgroundTileSources));
+	memset(spriteSources, 0, sizeof(spriteSources));
+	playerSheet = (Rectangle){0};
+	entryCount = 0;
+	bakedCount = 0;
+
+	Image tileset = Atlas_LoadTileset();
+	for (int tile = 1; tile < ATLAS_MAX_TILES; tile++)
+	{
+		Image special;
+		if (Atlas_BakeSpecialTile(tile, &special))
+		{
+			Atlas_AddBaked(special, &tileSources[tile]);
+		}
+		else
+		{
+			Rectangle src = {(tile % ATLAS_TILESET_COLUMNS) * TILE_SIZE,
+			                 (tile / ATLAS_TILESET_COLUMNS) * TILE_SIZE,
+			                 TILE_SIZE, TILE_SIZE};
+			if (src.x + src.width <= tileset.width &&
+			    src.y + src.height <= tileset.height)
+			{
+				Atlas_AddEntry(tileset, src, &tileSources[tile]);
+			}
+		}
+		Atlas_AddBaked(Atlas_BakeBackgroundTile(tile),
+		               &backgroundTileSources[tile]);
+	}
+
+	Image player = {0};
+	if (Pack_Exists(ASSET_PLAYER_PATH))
+	{
+		player = LoadImage(ASSET_PLAYER_PATH);
+		ImageFormat(&player, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+		Atlas_AddEntry(player,
+		               (Rectangle){0, 0, player.width, player.height},
+		               &playerSheet);
+	}
+
+	Atlas_AddBaked(GenImageColor(4, 4, WHITE),
+	               &spriteSources[ATLAS_SPRITE_WHITE]);
+	Image bullet = GenImageColor(ATLAS_BULLET_SIZE, ATLAS_BULLET_SIZE, BLANK);
+	ImageDrawCircle(&bullet, ATLAS_BULLET_SIZE / 2, ATLAS_BULLET_SIZE / 2,
+	                ATLAS_BULLET_SIZE / 2 - 1, WHITE);
+	Atlas_AddBaked(bullet, &spriteSources[ATLAS_SPRITE_BULLET]);
+	Atlas_AddBaked(Atlas_BakeCollectible(COLLECTIBLE_HEALTH_POINT),
+	               &spriteSources[ATLAS_SPRITE_HEALTH_POINT]);
+	Atlas_AddBaked(Atlas_BakeCollectible(COLLECTIBLE_SCORE),
+	               &spriteSources[ATLAS_SPRITE_SCORE_ITEM]);
+
+	Image atlas = GenImageColor(ATLAS_SIZE, ATLAS_SIZE, BLANK);
+	Atlas_Pack(&atlas);
+	atlasTexture = LoadTextureFromImage(atlas);
+	UnloadImage(atlas);
+	Mem_TrackTexture(MEM_TAG_ASSETS, &atlasTexture);
+
+	UnloadImage(tileset);
+	if (player.data != NULL)
+		UnloadImage(player);
+	for (int i = 0; i < bakedCount; i++)
+	{
+		UnloadImage(bakedImages[i]);
+	}
+	bakedCount = 0;
+	entryCount = 0;
+
+	// Shapes sample the white texel inside the atlas, so rectangles and
+	// circles batch together with the sprites around them.
+	Rectangle white = spriteSources[ATLAS_SPRITE_WHITE];
+	if (white.width > 0)
+	{
+		SetShapesTexture(atlasTexture,
+		                 (Rectangle){white.x + 1, white.y + 1, 1, 1});
+	}
+	atlasBuilt = true;
+}
+void Atlas_Unload(void)
+{
+	if (!atlasBuilt)
+		return;
+	SetShapesTexture((Texture2D){0}, (Rectangle){0});
+	Mem_UntrackTexture(&atlasTexture);
+	UnloadTexture(atlasTexture);
+	atlasTexture = (Texture2D){0};
+	atlasBuilt = false;
+}
+Texture2D Atlas_GetTexture(void) { return atlasTexture; }
+Rectangle Atlas_GetSprite(AtlasSprite sprite)
+{
+	if (sprite < 0 || sprite >= ATLAS_SPRITE_COUNT)
+		return (Rectangle){0, 0, 0, 0};
+	return spriteSources[sprite];
+}
+Rectangle Atlas_GetTileSource(int tileType)
+{
+	if (tileType <= 0 || tileType >= ATLAS_MAX_TILES)
+		return (Rectangle){0, 0, 0, 0};
+	return tileSources[tileType];
+}
+Rectangle Atlas_GetBackgroundTileSource(int tileType)
+{
+	if (tileType <= 0 || tileType >= ATLAS_MAX_TILES)
+		return (Rectangle){0, 0, 0, 0};
+	return backgroundTileSources[tileType];
+}
+bool Atlas_HasPlayerSprite(void) { return playerSheet.width > 0; }
+Rectangle Atlas_GetPlayerFrame(int animState, int animFrame)
+{
+	Rectangle frame = {playerSheet.x + animFrame * PLAYER_SIZE,
+	                   playerSheet.y + animState * PLAYER_SIZE, PLAYER_SIZE,
+	                   PLAYER_SIZE};
+	// Keep bad frame indices inside the sheet instead of sampling a
+	// neighbouring sprite.
+	if (frame.x + PLAYER_SIZE > playerSheet.x + playerSheet.width ||
+	    frame.y + PLAYER_SIZE > playerSheet.y + playerSheet.height)
+	{
+		frame.x = playerSheet.x;
+		frame.y = playerSheet.y;
+	}
+	return frame;
+}
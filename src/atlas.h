@@ -0,0 +1,26 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+#include "config.h"
+#include "raylib.h"
+typedef enum
+{
+	ATLAS_SPRITE_WHITE,
+	ATLAS_SPRITE_BULLET,
+	ATLAS_SPRITE_HEALTH_POINT,
+	ATLAS_SPRITE_SCORE_ITEM,
+	ATLAS_SPRITE_COUNT
+} AtlasSprite;
+void Atlas_Build(void);
+void Atlas_Unload(void);
+Texture2D Atlas_GetTexture(void);
+Rectangle Atlas_GetSprite(AtlasSprite sprite);
+Rectangle Atlas_GetTileSource(int tileType);
+Rectangle Atlas_GetBackgroundTileSource(int tileType);
+#ifdef CIRNO_HEADLESS
+// Without a window there is no atlas to draw the player from.
+#define Atlas_HasPlayerSprite() false
+#else
+bool Atlas_HasPlayerSprite(void);
+#endif
+Rectangle Atlas_GetPlayerFrame(int animState, int animFrame);
+#endif
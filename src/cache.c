@@ -0,0 +1,367 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "cache.h"
+#include "loader.h"
+#include "pack.h"
+#include "trace.h"
+#include <string.h>
+
+// One table for every file-backed asset outside the atlas. Each user holds a
+// reference by path, so a level change that asks for the same file again
+// gets the already-decoded copy instead of hitting the disk. Prefetched
+// entries decode on the loader threads and are uploaded by AssetCache_Update
+// a few at a time; acquiring one that is still pending finishes it on the
+// spot.
+typedef enum
+{
+	CACHE_KIND_TEXTURE,
+	CACHE_KIND_SOUND,
+	CACHE_KIND_MUSIC
+} CacheKind;
+
+typedef struct
+{
+	bool used;
+	char path[256];
+	unsigned int hash;
+	CacheKind kind;
+	AssetLifetime lifetime;
+	MemTag tag;
+	int refCount;
+	bool pending;
+	int job;
+	Texture2D texture;
+	Sound sound;
+	Music music;
+} CacheEntry;
+
+static CacheEntry entries[ASSET_CACHE_MAX_ENTRIES];
+
+static unsigned int AssetCache_Hash(const char *path)
+{
+	unsigned int hash = 2166136261u;
+	for (const char *c = path; *c; c++)
+	{
+		hash ^= (unsigned char)*c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+static CacheEntry *AssetCache_Find(const char *path)
+{
+	unsigned int hash = AssetCache_Hash(path);
+	for (int i = 0; i < ASSET_CACHE_MAX_ENTRIES; i++)
+	{
+		if (entries[i].used && entries[i].hash == hash &&
+		    strcmp(entries[i].path, path) == 0)
+			return &entries[i];
+	}
+	return NULL;
+}
+static void AssetCache_UnloadEntry(CacheEntry *entry)
+{
+	if (entry->pending)
+	{
+		Loader_Cancel(entry->job);
+		memset(entry, 0, sizeof(CacheEntry));
+		return;
+	}
+	switch (entry->kind)
+	{
+	case CACHE_KIND_TEXTURE:
+		Mem_UntrackTexture(&entry->texture);
+		if (entry->texture.id != 0)
+			UnloadTexture(entry->texture);
+		break;
+	case CACHE_KIND_SOUND:
+		Mem_UntrackSound(&entry->sound);
+		UnloadSound(entry->sound);
+		break;
+	case CACHE_KIND_MUSIC:
+		Mem_UntrackMusic(&entry->music);
+		UnloadMusicStream(entry->music);
+		break;
+	}
+	memset(entry, 0, sizeof(CacheEntry));
+}
+static Sound AssetCache_SilentSound(void)
+{
+	Wave wave = {0};
+	wave.frameCount = 4000;
+	wave.sampleRate = 44100;
+	wave.sampleSize = 16;
+	wave.channels = 1;
+	return LoadSoundFromWave(wave);
+}
+// Returns a free slot, evicting an unreferenced level asset if the table is
+// full. NULL means every slot is referenced. Nothing outside the table could
+// ever be released or unloaded, so acquires then fail as for a missing file.
+static CacheEntry *AssetCache_NewEntry(const char *path, CacheKind kind,
+                                       AssetLifetime lifetime, MemTag tag)
+{
+	CacheEntry *entry = NULL;
+	for (int i = 0; i < ASSET_CACHE_MAX_ENTRIES && !entry; i++)
+	{
+		if (!entries[i].used)
+			entry = &entries[i];
+	}
+	for (int i = 0; i < ASSET_CACHE_MAX_ENTRIES && !entry; i++)
+	{
+		if (entries[i].refCount == 0 &&
+		    entries[i].lifetime == ASSET_LIFETIME_LEVEL)
+		{
+			AssetCache_UnloadEntry(&entries[i]);
+			entry = &entries[i];
+		}
+	}
+	if (!entry)
+	{
+		TraceLog(LOG_WARNING, "CACHE: all %d slots referenced, cannot load %s",
+		         ASSET_CACHE_MAX_ENTRIES, path);
+		return NULL;
+	}
+	entry->used = true;
+	strncpy(entry->path, path, sizeof(entry->path) - 1);
+	entry->path[sizeof(entry->path) - 1] = '\0';
+	entry->hash = AssetCache_Hash(entry->path);
+	entry->kind = kind;
+	entry->lifetime = lifetime;
+	entry->tag = tag;
+	entry->refCount = 1;
+	entry->job = -1;
+	return entry;
+}
+// Uploads a prefetched entry's decoded data, waiting for the worker if it
+// has not got there yet.
+static void AssetCache_Finish(CacheEntry *entry)
+{
+	Trace_Begin("Upload");
+	if (entry->kind == CACHE_KIND_TEXTURE)
+	{
+		Image image = Loader_TakeImage(entry->job);
+		if (image.data != NULL)
+		{
+			entry->texture = LoadTextureFromImage(image);
+			UnloadImage(image);
+			Mem_TrackTexture(entry->tag, &entry->texture);
+		}
+	}
+	else
+	{
+		Wave wave = Loader_TakeWave(entry->job);
+		if (wave.data != NULL)
+		{
+			entry->sound = LoadSoundFromWave(wave);
+			UnloadWave(wave);
+		}
+		else
+		{
+			entry->sound = AssetCache_SilentSound();
+		}
+		Mem_TrackSound(entry->tag, &entry->sound);
+	}
+	entry->pending = false;
+	entry->job = -1;
+	Trace_End("Upload");
+}
+// Looks up an existing entry of the right kind and takes a reference. A
+// persistent request upgrades a level entry so it survives Collect.
+static CacheEntry *AssetCache_Reuse(const char *path, CacheKind kind,
+                                    AssetLifetime lifetime)
+{
+	CacheEntry *entry = AssetCache_Find(path);
+	if (!entry || entry->kind != kind)
+		return NULL;
+	entry->refCount++;
+	if (lifetime == ASSET_LIFETIME_PERSISTENT)
+		entry->lifetime = ASSET_LIFETIME_PERSISTENT;
+	if (entry->pending)
+		AssetCache_Finish(entry);
+	return entry;
+}
+// Starts decoding without taking a reference. A file that is missing or a
+// full loader queue is not an error; the later acquire loads it directly.
+static void AssetCache_Prefetch(const char *path, CacheKind kind,
+                                AssetLifetime lifetime, MemTag tag)
+{
+	CacheEntry *entry = AssetCache_Find(path);
+	if (entry)
+	{
+		if (lifetime == ASSET_LIFETIME_PERSISTENT)
+			entry->lifetime = ASSET_LIFETIME_PERSISTENT;
+		return;
+	}
+	if (!Pack_Exists(path))
+		return;
+	int job = kind == CACHE_KIND_TEXTURE ? Loader_QueueImage(path)
+	                                     : Loader_QueueWave(path);
+	if (job < 0)
+		return;
+	entry = AssetCache_NewEntry(path, kind, lifetime, tag);
+	if (!entry)
+	{
+		Loader_Cancel(job);
+		return;
+	}
+	entry->refCount = 0;
+	entry->pending = true;
+	entry->job = job;
+}
+void AssetCache_PrefetchTexture(const char *path, AssetLifetime lifetime,
+                                MemTag tag)
+{
+	AssetCache_Prefetch(path, CACHE_KIND_TEXTURE, lifetime, tag);
+}
+void AssetCache_PrefetchSound(const char *path, AssetLifetime lifetime,
+                              MemTag tag)
+{
+	AssetCache_Prefetch(path, CACHE_KIND_SOUND, lifetime, tag);
+}
+// True while a prefetch is still decoding or waiting for its upload, i.e.
+// while acquiring the path would block.
+bool AssetCache_IsPending(const char *path)
+{
+	CacheEntry *entry = AssetCache_Find(path);
+	return entry && entry->pending;
+}
+// Uploads finished prefetches until this frame's slice is used up; the
+// rest wait for the next frame.
+void AssetCache_Update(void)
+{
+	double start = GetTime();
+	for (int i = 0; i < ASSET_CACHE_MAX_ENTRIES; i++)
+	{
+		if (!entries[i].used || !entries[i].pending ||
+		    !Loader_IsDone(entries[i].job))
+			continue;
+		AssetCache_Finish(&entries[i]);
+		if (GetTime() - start > LOADER_UPLOAD_BUDGET)
+			break;
+	}
+}
+Texture2D AssetCache_AcquireTexture(const char *path, AssetLifetime lifetime,
+                                    MemTag tag)
+{
+	CacheEntry *entry = AssetCache_Reuse(path, CACHE_KIND_TEXTURE, lifetime);
+	if (entry)
+		return entry->texture;
+	Texture2D texture = {0};
+	if (!Pack_Exists(path))
+		return texture;
+	entry = AssetCache_NewEntry(path, CACHE_KIND_TEXTURE, lifetime, tag);
+	if (!entry)
+		return texture;
+	Trace_Begin("LoadTexture");
+	texture = LoadTexture(path);
+	Trace_End("LoadTexture");
+	if (texture.id == 0)
+	{
+		memset(entry, 0, sizeof(CacheEntry));
+		return texture;
+	}
+	entry->texture = texture;
+	Mem_TrackTexture(tag, &entry->texture);
+	return texture;
+}
+// A missing sound file is not an error: the game has always fallen back to
+// a short silent clip, so that placeholder is cached under the same path.
+Sound AssetCache_AcquireSound(const char *path, AssetLifetime lifetime,
+                              MemTag tag)
+{
+	CacheEntry *entry = AssetCache_Reuse(path, CACHE_KIND_SOUND, lifetime);
+	if (entry)
+		return entry->sound;
+	Sound sound = {0};
+	entry = AssetCache_NewEntry(path, CACHE_KIND_SOUND, lifetime, tag);
+	if (!entry)
+		return sound;
+	if (Pack_Exists(path))
+	{
+		Trace_Begin("LoadSound");
+		sound = LoadSound(path);
+		Trace_End("LoadSound");
+	}
+	else
+	{
+		sound = AssetCache_SilentSound();
+	}
+	entry->sound = sound;
+	Mem_TrackSound(tag, &entry->sound);
+	return sound;
+}
+Music AssetCache_AcquireMusic(const char *path, AssetLifetime lifetime,
+                              MemTag tag)
+{
+	CacheEntry *entry = AssetCache_Reuse(path, CACHE_KIND_MUSIC, lifetime);
+	if (entry)
+		return entry->music;
+	Music music = {0};
+	entry = AssetCache_NewEntry(path, CACHE_KIND_MUSIC, lifetime, tag);
+	if (!entry)
+		return music;
+	// Packed tracks stream straight out of the mapped pack.
+	Trace_Begin("LoadMusicStream");
+	int packedSize = 0;
+	const unsigned char *packed = Pack_Find(path, &packedSize);
+	if (packed)
+		music = LoadMusicStreamFromMemory(GetFileExtension(path), packed,
+		                                  packedSize);
+	else
+		music = LoadMusicStream(path);
+	Trace_End("LoadMusicStream");
+	if (music.stream.buffer == NULL)
+	{
+		memset(entry, 0, sizeof(CacheEntry));
+		return music;
+	}
+	entry->music = music;
+	Mem_TrackMusic(tag, &entry->music);
+	return music;
+}
+// Dropping the last reference does not unload anything by itself; the
+// asset stays warm until Collect runs at a point where a reload is cheap.
+void AssetCache_Release(const char *path)
+{
+	CacheEntry *entry = AssetCache_Find(path);
+	if (entry && entry->refCount > 0)
+		entry->refCount--;
+}
+void AssetCache_Collect(void)
+{
+	for (int i = 0; i < ASSET_CACHE_MAX_ENTRIES; i++)
+	{
+		if (entries[i].used && entries[i].refCount == 0 &&
+		    entries[i].lifetime == ASSET_LIFETIME_LEVEL)
+			AssetCache_UnloadEntry(&entries[i]);
+	}
+}
+void AssetCache_Shutdown(void)
+{
+	for (int i = 0; i < ASSET_CACHE_MAX_ENTRIES; i++)
+	{
+		if (entries[i].used)
+		{
+			if (entries[i].refCount > 0 &&
+			    entries[i].lifetime == ASSET_LIFETIME_LEVEL)
+				TraceLog(LOG_WARNING, "CACHE: %s still referenced at shutdown",
+				         entries[i].path);
+			AssetCache_UnloadEntry(&entries[i]);
+		}
+	}
+}
@@ -0,0 +1,29 @@
+#ifndef CACHE_H
+#define CACHE_H
+#include "config.h"
+#include "memtrack.h"
+#include "raylib.h"
+// Level assets are dropped by AssetCache_Collect once nothing references
+// them; persistent ones stay loaded until AssetCache_Shutdown. The tag is
+// the subsystem whose memory budget a newly loaded asset counts against.
+typedef enum
+{
+	ASSET_LIFETIME_LEVEL,
+	ASSET_LIFETIME_PERSISTENT
+} AssetLifetime;
+Texture2D AssetCache_AcquireTexture(const char *path, AssetLifetime lifetime,
+                                    MemTag tag);
+Sound AssetCache_AcquireSound(const char *path, AssetLifetime lifetime,
+                              MemTag tag);
+Music AssetCache_AcquireMusic(const char *path, AssetLifetime lifetime,
+                              MemTag tag);
+void AssetCache_PrefetchTexture(const char *path, AssetLifetime lifetime,
+                                MemTag tag);
+void AssetCache_PrefetchSound(const char *path, AssetLifetime lifetime,
+                              MemTag tag);
+bool AssetCache_IsPending(const char *path);
+void AssetCache_Update(void);
+void AssetCache_Release(const char *path);
+void AssetCache_Collect(void);
+void AssetCache_Shutdown(void);
+#endif
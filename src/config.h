@@ -9,6 +9,18 @@
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 600
 #define TARGET_FPS 60
+#define SKY_COLOR (Color){135, 206, 235, 255}
+
+// Internal world render resolution, as a fraction of the window size
+#define RENDER_SCALE_MIN 0.5f
+#define RENDER_SCALE_MAX 1.0f
+#define RENDER_SCALE_STEP 0.05f
+#define RENDER_FRAME_BUDGET (1.0f / TARGET_FPS)
+
+// World draw command buffer, flushed once per frame (or early when full)
+#define RENDER_QUEUE_CAPACITY 8192
+#define RENDER_QUEUE_MAX_TEXTURES 16
+#define RENDER_QUEUE_TEXT_POOL 4096
 
 //=============================================================================
 // TILE AND WORLD SETTINGS
@@ -16,8 +28,14 @@
 #define TILE_SIZE 50
 #define MIN_WORLD_WIDTH 20
 #define MIN_WORLD_HEIGHT 15
+// Stress builds may raise these, e.g. -DMAX_WORLD_WIDTH=512, to load the
+// oversized levels from tools/lvlgen.c.
+#ifndef MAX_WORLD_WIDTH
 #define MAX_WORLD_WIDTH 128
+#endif
+#ifndef MAX_WORLD_HEIGHT
 #define MAX_WORLD_HEIGHT 128
+#endif
 #define BACKGROUND_TILE_START 20
 
 //=============================================================================
@@ -79,6 +97,8 @@
 #define LEVELS_PER_WORLD 9
 #define MAX_CUSTOM_WORLDS 100
 #define MAX_SAVE_SLOTS 5
+#define MAX_SAVE_FILES 512
+#define SAVE_FORMAT_VERSION 2
 
 
 //=============================================================================
@@ -86,13 +106,64 @@
 //=============================================================================
 #define ASSET_LEVEL_PATH "asset/levels/%s.lvl"
 #define ASSET_PLAYER_PATH "asset/sprites/player.png"
+#define ASSET_TILESET_PATH "assets/tiles/tileset.png"
+#define ASSET_PACK_PATH "assets.pak"
+#define LEVEL_FORMAT_VERSION 2
+#define MANIFEST_POLL_INTERVAL 1.0f // seconds, where there is no inotify
+
+// Texture atlas
+#define ATLAS_SIZE 1024
+#define ATLAS_PADDING 2
+#define ATLAS_MAX_TILES 100
+
+// Shared texture/sound/music cache (see cache.c)
+#define ASSET_CACHE_MAX_ENTRIES 128
+
+// Background decoding; uploads get this many seconds of each frame
+#define LOADER_THREAD_COUNT 2
+#define LOADER_MAX_JOBS 64
+#define LOADER_UPLOAD_BUDGET 0.004f
+
+// Seconds for one level's music to fade into the next
+#define MUSIC_CROSSFADE_TIME 1.0f
+
+// F3 profiler overlay: frames kept for the graph, frames averaged per row
+#define PROFILER_HISTORY 120
+#define PROFILER_AVERAGE_FRAMES 30
+
+// Chrome trace recording (F4): events kept, threads told apart, output file
+#define TRACE_CAPACITY 65536
+#define TRACE_MAX_THREADS 8
+#define TRACE_FILE "trace.json"
+
+// Memory accounting (F5 overlay, F6 dump): GPU and audio objects tracked
+#define MEM_MAX_RESOURCES 256
+#define MEM_DUMP_FILE "memory.txt"
+
+// Gameplay counters: seconds per CSV row, rows between writes, log cap
+#define COUNTERS_SAMPLE_INTERVAL 1.0f
+#define COUNTERS_WRITE_ROWS 10
+#define COUNTERS_MAX_BYTES (4 * 1024 * 1024)
+#define COUNTERS_FILE "counters.csv"
+
+// Hitch log (F7 histogram): frames slower than the threshold are logged
+// (CIRNO_HITCH_MS overrides it), histogram buckets, log cap and file
+#define HITCH_THRESHOLD_MS 33.3f
+#define HITCH_BUCKET_MS 0.5f
+#define HITCH_BUCKETS 200
+#define HITCH_MAX_BYTES (256 * 1024)
+#define HITCH_WRITE_INTERVAL 5.0f
+#define HITCH_FILE "hitches.log"
 
 //=============================================================================
 // ENTITY LIMITS
 //=============================================================================
 #define MAX_ENTITIES 100
 #define MAX_MUSIC_FILES 50
+// tools/sandbox.c is built with a far larger MAX_BULLETS.
+#ifndef MAX_BULLETS
 #define MAX_BULLETS 500
+#endif
 #define MAX_SPAWNERS 50
 #define MAX_COLLECTIBLES 200
 #define MAX_PARRY_EFFECTS 50
@@ -249,6 +320,7 @@ typedef struct
 	Color bulletColor;
 	float bulletSize;
 	int health;  // Spawner health - decreases when hit by parried bullets
+	unsigned int rng; // own random state, see Spawner_Random
 } BulletSpawner;
 
 typedef struct
@@ -317,5 +389,7 @@ typedef struct
 	float masterVolume;
 	ResolutionMode resolution;
 	KeyBindings keys;
+	float renderScale;
+	bool dynamicResolution;
 } Settings;
 #endif
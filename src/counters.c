@@ -0,0 +1,139 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "counters.h"
+#include "config.h"
+#include "memtrack.h"
+#include "writer.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *counterNames[COUNTER_COUNT] = {
+    "bullets_spawned",      "bullets_despawned",      "bullets_truncated",
+    "collision_tests",      "parries",                "collectibles_spawned",
+    "collectibles_dropped", "bullets_live",           "active_spawners",
+    "tiles_drawn"};
+static long counters[COUNTER_COUNT];
+static float sampleTime = 0.0f;
+static float frameTimeSum = 0.0f;
+static float frameTimeMax = 0.0f;
+static int frameCount = 0;
+static double sessionTime = 0.0;
+// The whole log is kept and rewritten through the writer thread every
+// COUNTERS_WRITE_ROWS rows, so the main thread never touches the disk.
+static char *csv = NULL;
+static int csvSize = 0;
+static int csvCapacity = 0;
+static int pendingRows = 0;
+static bool csvFull = false;
+
+static void Counters_Append(const char *text, int length)
+{
+	if (csvFull)
+		return;
+	if (csvSize + length > COUNTERS_MAX_BYTES)
+	{
+		TraceLog(LOG_WARNING, "COUNTERS: %s is full, no more rows",
+		         COUNTERS_FILE);
+		csvFull = true;
+		return;
+	}
+	if (csvSize + length > csvCapacity)
+	{
+		int capacity = csvCapacity > 0 ? csvCapacity * 2 : 16384;
+		while (capacity < csvSize + length)
+			capacity *= 2;
+		char *grown = (char *)Mem_Realloc(MEM_TAG_OTHER, csv, capacity);
+		if (!grown)
+		{
+			csvFull = true;
+			return;
+		}
+		csv = grown;
+		csvCapacity = capacity;
+	}
+	memcpy(csv + csvSize, text, length);
+	csvSize += length;
+}
+static void Counters_Write(void)
+{
+	if (csvSize > 0)
+		Writer_Submit(COUNTERS_FILE, csv, csvSize);
+	pendingRows = 0;
+}
+static void Counters_Sample(void)
+{
+	char row[512];
+	int length = snprintf(row, sizeof(row), "%.1f,%d,%.2f,%.2f",
+	                      sessionTime, frameCount,
+	                      frameTimeSum * 1000.0f / frameCount,
+	                      frameTimeMax * 1000.0f);
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		length += snprintf(row + length, sizeof(row) - length, ",%ld",
+		                   counters[i]);
+		counters[i] = 0;
+	}
+	length += snprintf(row + length, sizeof(row) - length, "\n");
+	Counters_Append(row, length);
+	sampleTime = 0.0f;
+	frameTimeSum = 0.0f;
+	frameTimeMax = 0.0f;
+	frameCount = 0;
+	if (++pendingRows >= COUNTERS_WRITE_ROWS)
+		Counters_Write();
+}
+void Counters_Init(void)
+{
+	char header[512];
+	int length = snprintf(header, sizeof(header),
+	                      "time_s,frames,frame_ms_avg,frame_ms_max");
+	for (int i = 0; i < COUNTER_COUNT; i++)
+		length += snprintf(header + length, sizeof(header) - length, ",%s",
+		                   counterNames[i]);
+	length += snprintf(header + length, sizeof(header) - length, "\n");
+	Counters_Append(header, length);
+}
+// Writes the last, partial second too.
+void Counters_Shutdown(void)
+{
+	if (frameCount > 0)
+		Counters_Sample();
+	Counters_Write();
+	Mem_Free(csv);
+	csv = NULL;
+	csvSize = 0;
+	csvCapacity = 0;
+}
+void Counters_Add(Counter counter, int amount) { counters[counter] += amount; }
+void Counters_Gauge(Counter counter, int value)
+{
+	if (value > counters[counter])
+		counters[counter] = value;
+}
+void Counters_NewFrame(float frameTime)
+{
+	frameCount++;
+	frameTimeSum += frameTime;
+	if (frameTime > frameTimeMax)
+		frameTimeMax = frameTime;
+	sampleTime += frameTime;
+	sessionTime += frameTime;
+	if (sampleTime >= COUNTERS_SAMPLE_INTERVAL)
+		Counters_Sample();
+}
@@ -0,0 +1,33 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+// Always-on gameplay counters. Once a second they become a row of
+// COUNTERS_FILE next to that second's frame times. Events are summed over
+// the second; gauges keep the highest value seen in it. Main thread only.
+typedef enum
+{
+	COUNTER_BULLETS_SPAWNED,
+	COUNTER_BULLETS_DESPAWNED,
+	COUNTER_BULLETS_TRUNCATED,    // cut from a volley by MAX_BULLETS
+	COUNTER_COLLISION_TESTS,
+	COUNTER_PARRIES,
+	COUNTER_COLLECTIBLES_SPAWNED,
+	COUNTER_COLLECTIBLES_DROPPED, // refused near MAX_COLLECTIBLES
+	// Gauges from here on.
+	COUNTER_BULLETS_LIVE,
+	COUNTER_ACTIVE_SPAWNERS,
+	COUNTER_TILES_DRAWN,
+	COUNTER_COUNT
+} Counter;
+#define COUNTER_FIRST_GAUGE COUNTER_BULLETS_LIVE
+void Counters_Init(void);
+void Counters_Shutdown(void);
+#ifdef CIRNO_HEADLESS
+// The simulation library keeps no counters file.
+#define Counters_Add(counter, amount) ((void)(counter), (void)(amount))
+#define Counters_Gauge(counter, value) ((void)(counter), (void)(value))
+#else
+void Counters_Add(Counter counter, int amount);
+void Counters_Gauge(Counter counter, int value);
+#endif
+void Counters_NewFrame(float frameTime);
+#endif
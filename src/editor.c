@@ -17,45 +17,20 @@
  */
 
 #include "editor.h"
+#include "manifest.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
-// Comparison function for sorting level filenames
-static int CompareFilenames(const void *a, const void *b)
-{
-	const char *str_a = (const char *)a;
-	const char *str_b = (const char *)b;
-	return strcmp(str_a, str_b);
-}
-
+// The list itself lives in the level manifest; this only resyncs the
+// editor's count with it.
 void Editor_RefreshLevelList(LevelEditor *editor)
 {
-	FilePathList files = LoadDirectoryFiles("assets/levels");
-	editor->totalLevelFiles = 0;
-	
-	// Collect all .lvl files
-	for (unsigned int i = 0;
-	     i < files.count && editor->totalLevelFiles < MAX_LEVELS; i++)
-	{
-		const char *ext = GetFileExtension(files.paths[i]);
-		if (TextIsEqual(ext, ".lvl"))
-		{
-			strncpy(editor->levelFiles[editor->totalLevelFiles], files.paths[i],
-			        255);
-			editor->levelFiles[editor->totalLevelFiles][255] = '\0';
-			editor->totalLevelFiles++;
-		}
-	}
-	UnloadDirectoryFiles(files);
-	
-	// Sort level files alphabetically
-	if (editor->totalLevelFiles > 0)
-	{
-		qsort(editor->levelFiles, editor->totalLevelFiles, 
-		      sizeof(editor->levelFiles[0]), CompareFilenames);
-	}
-	
+	// Our own save may not have been picked up by the watcher yet.
+	if (editor->needsRefresh)
+		Manifest_Refresh();
+	editor->totalLevelFiles = Manifest_GetCount();
+	editor->manifestVersion = Manifest_GetVersion();
 	editor->needsRefresh = false;
 }
 
@@ -75,6 +50,8 @@ void Editor_SaveLevel(LevelEditor *editor)
 	char filepath[512];
 	snprintf(filepath, sizeof(filepath), ASSET_LEVEL_PATH, // "assets/levels/%s.lvl",
 	         editor->levelName);
+	// The level may still be reading from the file about to be replaced.
+	Level_Detach(&editor->level);
 	Level_SaveToFile(&editor->level, filepath);
 	snprintf(editor->statusMessage, sizeof(editor->statusMessage), "Saved: %s",
 	         editor->levelName);
@@ -87,8 +64,9 @@ void Editor_LoadLevel(LevelEditor *editor, int index)
 	if (index < 0 || index >= editor->totalLevelFiles)
 		return;
 	Level_Unload(&editor->level);
-	Level_LoadFromFile(&editor->level, editor->levelFiles[index]);
-	const char *fname = GetFileNameWithoutExt(editor->levelFiles[index]);
+	const LevelManifestEntry *entry = Manifest_GetEntry(index);
+	Level_LoadFromFile(&editor->level, entry->path);
+	const char *fname = entry->name;
 	strncpy(editor->levelName, fname, 255);
 	editor->levelName[255] = '\0';
 	strncpy(editor->levelNameBuffer, fname, 255);
@@ -36,7 +36,7 @@ typedef struct
 	int levelHeight;
 	int currentLevelIndex;
 	int totalLevelFiles;
-	char levelFiles[MAX_LEVELS][256];
+	unsigned int manifestVersion;
 	bool uiInteracting;
 	bool needsRefresh;
 	char statusMessage[256];
@@ -20,11 +20,24 @@
 // level editor.
 // TODO: move the level editor to a different source file.
 #include "game.h"
+#include "atlas.h"
+#include "cache.h"
+#include "counters.h"
 #include "editor.h"
+#include "hitch.h"
+#include "loader.h"
+#include "manifest.h"
+#include "memtrack.h"
 #include "menu.h"
+#include "pack.h"
 #include "draw.h"
+#include "profiler.h"
+#include "render.h"
+#include "renderqueue.h"
 #include "save.h"
+#include "trace.h"
 #include "vn.h"
+#include "writer.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -70,7 +83,109 @@ static Texture2D menuBgAllStages;
 static Texture2D menuBgPerfect;
 static bool menuBgLoaded = false;
 static float achievementNotifTimer = 0;
+static bool menuBgFromFile[3] = {false, false, false};
+static bool menuBgGradient[3] = {false, false, false}; // ours, not the cache's
 
+#define MENU_BG_DEFAULT_PATH "assets/menu_bg_default.png"
+#define MENU_BG_COMPLETE_PATH "assets/menu_bg_complete.png"
+#define MENU_BG_PERFECT_PATH "assets/menu_bg_perfect.png"
+
+static Texture2D Game_LoadGradient(Color top, Color bottom)
+{
+	Image img =
+	    GenImageGradientLinear(SCREEN_WIDTH, SCREEN_HEIGHT, 0, top, bottom);
+	Texture2D texture = LoadTextureFromImage(img);
+	UnloadImage(img);
+	Mem_TrackTexture(MEM_TAG_ASSETS, &texture);
+	return texture;
+}
+// Swaps a gradient for its image file once the background decode is done.
+static void Game_SwapMenuBackground(Texture2D *bg, bool *fromFile,
+                                    bool *gradient, const char *path)
+{
+	if (*fromFile || AssetCache_IsPending(path))
+		return;
+	*fromFile = true;
+	if (!Pack_Exists(path))
+		return;
+	Texture2D texture = AssetCache_AcquireTexture(
+	    path, ASSET_LIFETIME_PERSISTENT, MEM_TAG_ASSETS);
+	if (texture.id != 0)
+	{
+		Mem_UntrackTexture(bg);
+		UnloadTexture(*bg);
+		*bg = texture;
+		*gradient = false;
+	}
+}
+static void Game_UpdateMenuBackgrounds(void)
+{
+	Game_SwapMenuBackground(&menuBgDefault, &menuBgFromFile[0],
+	                        &menuBgGradient[0], MENU_BG_DEFAULT_PATH);
+	Game_SwapMenuBackground(&menuBgAllStages, &menuBgFromFile[1],
+	                        &menuBgGradient[1], MENU_BG_COMPLETE_PATH);
+	Game_SwapMenuBackground(&menuBgPerfect, &menuBgFromFile[2],
+	                        &menuBgGradient[2], MENU_BG_PERFECT_PATH);
+}
+// Image files that replaced a gradient are the cache's to unload.
+static void Game_UnloadMenuBackgrounds(void)
+{
+	Texture2D *backgrounds[3] = {&menuBgDefault, &menuBgAllStages,
+	                             &menuBgPerfect};
+	for (int i = 0; i < 3; i++)
+	{
+		if (!menuBgGradient[i])
+			continue;
+		Mem_UntrackTexture(backgrounds[i]);
+		UnloadTexture(*backgrounds[i]);
+		menuBgGradient[i] = false;
+	}
+	menuBgLoaded = false;
+}
+
+// Starts the loaded level's track, crossfading from whatever was playing.
+static void Game_PlayLevelMusic(void)
+{
+	if (!settings || !settings->soundEnabled)
+		return;
+	if (strlen(world.level.musicFile) > 0)
+	{
+		Assets_PlayMusic(&world.assets, world.level.musicFile);
+	}
+	else
+	{
+		Assets_StopMusic(&world.assets);
+	}
+}
+// Opens the next level's track while the level complete screen is up.
+static void Game_PrefetchNextMusic(void)
+{
+	char musicFile[256];
+	if (!settings || !settings->soundEnabled)
+		return;
+	if (gameData.currentLevel + 1 >= gameData.totalLevels)
+		return;
+	if (Level_ReadMusicFile(gameData.currentLevel + 1, musicFile) &&
+	    strlen(musicFile) > 0)
+	{
+		Assets_PrefetchMusic(&world.assets, musicFile);
+	}
+}
+// The big fixed arrays live in these statics rather than on the heap, so
+// they are counted once here.
+static void Game_TrackStaticMemory(void)
+{
+	size_t bullets = sizeof(world.spawners) + sizeof(world.bullets) +
+	                 sizeof(world.collectibles) + sizeof(world.parryEffects);
+	Mem_TrackStatic(MEM_TAG_LEVEL, sizeof(world.level));
+	Mem_TrackStatic(MEM_TAG_ASSETS, sizeof(world.assets));
+	Mem_TrackStatic(MEM_TAG_BULLETS, bullets);
+	Mem_TrackStatic(MEM_TAG_OTHER, sizeof(world) - sizeof(world.level) -
+	                                   sizeof(world.assets) - bullets);
+	Mem_TrackStatic(MEM_TAG_EDITOR, sizeof(editor));
+	Mem_TrackStatic(MEM_TAG_VN, sizeof(vnState));
+	Mem_TrackStatic(MEM_TAG_SAVES, sizeof(gameData) + sizeof(saveSlots));
+}
 void Game_Init(void)
 {
 
@@ -85,11 +200,26 @@ void Game_Init(void)
 
 	// for the save files
 	mkdir("saves", 0777);
+	// Saves and achievements are written off the main thread.
+	Writer_Init();
+	Trace_Init();
+	Counters_Init();
+	Hitch_Init();
+	Game_TrackStaticMemory();
+	// Loose files under assets/ still override anything in the pack.
+	Pack_Open(ASSET_PACK_PATH);
+	Manifest_Init();
 
 	InitAudioDevice();
+	// Without worker threads everything still loads, just synchronously.
+	Loader_Init();
+	Assets_Preload();
+	// Needs the window (and its default font) to bake the world sprites.
+	Atlas_Build();
 	Menu_Init();
 	Pause_Init();
 	settings = Menu_GetSettings();
+	Render_Init(settings);
 	currentState = STATE_MENU;
 	worldLoaded = false;
 	editorLoaded = false;
@@ -97,47 +227,26 @@ void Game_Init(void)
 	Achievement_Load(&gameData.achievements);
 
 	// This is basically different main menu screens for different level of
-	// progression
+	// progression. The gradients show up right away; the image files decode
+	// in the background and replace them in Game_UpdateMenuBackgrounds.
 	if (!menuBgLoaded)
 	{
-		if (FileExists("assets/menu_bg_default.png"))
-		{
-			menuBgDefault = LoadTexture("assets/menu_bg_default.png");
-		}
-		else
-		{
-			Image img = GenImageGradientLinear(SCREEN_WIDTH, SCREEN_HEIGHT, 0,
-			                                   DARKBLUE, SKYBLUE);
-			menuBgDefault = LoadTextureFromImage(img);
-			UnloadImage(img);
-		}
-		if (FileExists("assets/menu_bg_complete.png"))
-		{
-			menuBgAllStages = LoadTexture("assets/menu_bg_complete.png");
-		}
-		else
-		{
-			Image img = GenImageGradientLinear(SCREEN_WIDTH, SCREEN_HEIGHT, 0,
-			                                   DARKPURPLE, PURPLE);
-			menuBgAllStages = LoadTextureFromImage(img);
-			UnloadImage(img);
-		}
-		if (FileExists("assets/menu_bg_perfect.png"))
-		{
-			menuBgPerfect = LoadTexture("assets/menu_bg_perfect.png");
-		}
-		else
-		{
-			Image img = GenImageGradientLinear(SCREEN_WIDTH, SCREEN_HEIGHT, 0,
-			                                   ORANGE, GOLD);
-			menuBgPerfect = LoadTextureFromImage(img);
-			UnloadImage(img);
-		}
+		menuBgDefault = Game_LoadGradient(DARKBLUE, SKYBLUE);
+		menuBgAllStages = Game_LoadGradient(DARKPURPLE, PURPLE);
+		menuBgPerfect = Game_LoadGradient(ORANGE, GOLD);
+		for (int i = 0; i < 3; i++)
+			menuBgGradient[i] = true;
+		AssetCache_PrefetchTexture(MENU_BG_DEFAULT_PATH,
+		                           ASSET_LIFETIME_PERSISTENT, MEM_TAG_ASSETS);
+		AssetCache_PrefetchTexture(MENU_BG_COMPLETE_PATH,
+		                           ASSET_LIFETIME_PERSISTENT, MEM_TAG_ASSETS);
+		AssetCache_PrefetchTexture(MENU_BG_PERFECT_PATH,
+		                           ASSET_LIFETIME_PERSISTENT, MEM_TAG_ASSETS);
 		menuBgLoaded = true;
 	}
-	SaveMetadata saveMeta[50];
+	// Scans saves/ once up front; the load screen then reads the cached list.
 	int saveCount = 0;
-	Save_GetAllSaveFiles(saveMeta, 50, &saveCount);
+	Save_GetSaveList(&saveCount);
 	for (int i = 0; i < MAX_SAVE_SLOTS; i++)
 	{
 		saveSlots[i].isValid = false;
@@ -198,16 +307,12 @@ void Game_StartNewWithName(void)
 	{
 		currentState = STATE_PLAYING;
 	}
-	if (settings && settings->soundEnabled)
-	{
-		if (strlen(world.level.musicFile) > 0)
-		{
-			Assets_PlayMusic(&world.assets, world.level.musicFile);
-		}
-	}
+	Game_PlayLevelMusic();
 }
 void Game_LoadSave(void)
 {
+	// Picks up saves copied into saves/ while the game was running.
+	Save_InvalidateList();
 	currentState = STATE_LOAD_GAME;
 	saveSlotSelection = 0;
 }
@@ -254,6 +359,7 @@ void Game_NextLevel(void)
 			gameData.achievements.newUnlock = false;
 		}
 		Game_SaveProgress();
+		Assets_StopMusic(&world.assets);
 		currentState = STATE_CREDITS;
 		creditsScrollY = SCREEN_HEIGHT;
 		worldLoaded = false;
@@ -262,6 +368,9 @@ void Game_NextLevel(void)
 	{
 		World_Load(&world, gameData.currentLevel);
 		worldLoaded = true;
+		// Whatever the previous level used and this one did not is dropped,
+		// before the new scene starts prefetching its own assets.
+		AssetCache_Collect();
 		if (world.level.hasVisualNovel && world.level.dialogueCount > 0)
 		{
 			VN_Init(&vnState, &world.level);
@@ -271,13 +380,7 @@ void Game_NextLevel(void)
 		{
 			currentState = STATE_PLAYING;
 		}
-		if (settings && settings->soundEnabled)
-		{
-			if (strlen(world.level.musicFile) > 0)
-			{
-				Assets_PlayMusic(&world.assets, world.level.musicFile);
-			}
-		}
+		Game_PlayLevelMusic();
 	}
 }
 void Game_StartLevelEditor(void)
@@ -333,11 +436,51 @@ void Game_StartLevelEditor(void)
 	EditorPause_SetSelection(0);
 }
 
+static const char *Game_GetStateName(GameState state)
+{
+	static const char *names[] = {
+	    "Menu",          "Name input",      "Load game",  "Playing",
+	    "Paused",        "Death screen",    "Level complete",
+	    "Game complete", "Credits",         "Visual novel",
+	    "Level editor",  "Editor paused",   "VN editor"};
+	if (state < 0 || state >= (int)(sizeof(names) / sizeof(names[0])))
+		return "Unknown";
+	return names[state];
+}
+// Hands the hitch log what the game was doing during the frame that just
+// ended.
+static void Game_CheckHitch(float frameTime)
+{
+	HitchContext context = {Game_GetStateName(currentState), 0, 0, 0};
+	if (worldLoaded)
+	{
+		context.bullets = world.bulletCount;
+		context.collectibles = world.collectibleCount;
+		context.spawners = world.spawnerCount;
+	}
+	Hitch_NewFrame(frameTime, &context);
+}
 // This is what the main game Loop runs.
 void Game_Update(void)
 {
 
 	float dt = GetFrameTime();
+	Profiler_NewFrame(dt);
+	Counters_NewFrame(dt);
+	Game_CheckHitch(dt);
+	if (IsKeyPressed(KEY_F3))
+		Profiler_Toggle();
+	if (IsKeyPressed(KEY_F4))
+		Trace_SetRecording(!Trace_IsRecording());
+	if (IsKeyPressed(KEY_F5))
+		Mem_Toggle();
+	if (IsKeyPressed(KEY_F6))
+		Mem_Dump(MEM_DUMP_FILE);
+	if (IsKeyPressed(KEY_F7))
+		Hitch_Toggle();
+	Render_Update(dt);
+	AssetCache_Update();
+	Manifest_Update(dt);
 
 	// Achivement stuffs.
 	if (achievementNotifTimer > 0)
@@ -346,17 +489,14 @@ void Game_Update(void)
 	}
 
 	// Audio stuff
-	if (worldLoaded && settings && settings->soundEnabled)
-	{
-		Assets_UpdateMusic(&world.assets);
-	}
-	if (editorLoaded && settings && settings->soundEnabled)
+	if (settings && settings->soundEnabled)
 	{
-		Assets_UpdateMusic(&editor.assets);
+		Assets_UpdateMusic(dt);
 	}
 
 	if (currentState == STATE_MENU)
 	{
+		Game_UpdateMenuBackgrounds();
 		Menu_Update();
 
 		// This case handles creating a new game,
@@ -396,9 +536,8 @@ void Game_Update(void)
 	}
 	else if (currentState == STATE_LOAD_GAME)
 	{
-		SaveMetadata saves[50];
 		int saveCount = 0;
-		Save_GetAllSaveFiles(saves, 50, &saveCount);
+		const SaveMetadata *saves = Save_GetSaveList(&saveCount);
 		if (IsKeyPressed(KEY_DOWN) && saveCount > 0)
 		{
 			saveSlotSelection = (saveSlotSelection + 1) % saveCount;
@@ -414,7 +553,6 @@ void Game_Update(void)
 			         saves[saveSlotSelection].saveName);
 			if (Save_Read(&gameData, filename))
 			{
-				Achievement_FixPointers(&gameData.achievements);
 				if (worldLoaded)
 				{
 					World_Unload(&world);
@@ -424,13 +562,7 @@ void Game_Update(void)
 				world.player.canSpellCard = gameData.canSpellCard;
 				currentState = STATE_PLAYING;
 				worldLoaded = true;
-				if (settings && settings->soundEnabled)
-				{
-					if (strlen(world.level.musicFile) > 0)
-					{
-						Assets_PlayMusic(&world.assets, world.level.musicFile);
-					}
-				}
+				Game_PlayLevelMusic();
 			}
 		}
 		if (IsKeyPressed(KEY_ESCAPE))
@@ -482,7 +614,8 @@ void Game_Update(void)
 	}
 	else if (currentState == STATE_LEVEL_EDITOR)
 	{
-		if (editor.needsRefresh)
+		if (editor.needsRefresh ||
+		    editor.manifestVersion != Manifest_GetVersion())
 		{
 			Editor_RefreshLevelList(&editor);
 		}
@@ -636,12 +769,15 @@ void Game_Update(void)
 			}
 		}
 		
-		World_Update(&world, dt, &settings->keys);
+		PlayerInput input = Player_ReadInput(&settings->keys);
+		World_Update(&world, dt, &input);
 		
 		// Collect items
 		int healthCollected = 0;
 		int scoreCollected = 0;
+		PROFILE_BEGIN(PROFILE_COLLECT);
 		World_CollectItems(&world, &healthCollected, &scoreCollected);
+		PROFILE_END(PROFILE_COLLECT);
 		
 		// Add health points, but cap at max. Convert overflow to score
 		int newHealthPoints = gameData.healthPoints + healthCollected;
@@ -694,6 +830,11 @@ void Game_Update(void)
 			
 			// Transition to level complete screen (Game_NextLevel will increment currentLevel)
 			Assets_PlayLevelCompleteSound(&world.assets);
+			// The next level decodes while this screen is up, so moving on
+			// only swaps it in.
+			if (gameData.currentLevel + 1 < gameData.totalLevels)
+				World_Preload(gameData.currentLevel + 1);
+			Game_PrefetchNextMusic();
 			currentState = STATE_LEVEL_COMPLETE;
 			levelCompleteTimer = 0;
 		}
@@ -720,6 +861,8 @@ void Game_Update(void)
 					World_Unload(&world);
 					worldLoaded = false;
 				}
+				// Back at the menu nothing needs the level's assets any more.
+				AssetCache_Collect();
 				currentState = STATE_MENU;
 			}
 		}
@@ -731,8 +874,9 @@ void Game_Update(void)
 	else if (currentState == STATE_LEVEL_COMPLETE)
 	{
 		levelCompleteTimer += dt;
+		// Skipping ahead waits for the preload; the timer lets it finish.
 		if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_SPACE) ||
-		    levelCompleteTimer > 3.0f)
+		    (levelCompleteTimer > 3.0f && !World_IsPreloading()))
 		{
 			Game_NextLevel();
 		}
@@ -741,6 +885,7 @@ void Game_Update(void)
 	{
 		if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_SPACE))
 		{
+			AssetCache_Collect();
 			currentState = STATE_MENU;
 		}
 	}
@@ -877,9 +1022,8 @@ void Game_Draw(void)
 	{
 		ClearBackground((Color){20, 20, 40, 255});
 		DrawText("LOAD GAME", SCREEN_WIDTH / 2 - 120, 80, 40, SKYBLUE);
-		SaveMetadata saves[50];
 		int saveCount = 0;
-		Save_GetAllSaveFiles(saves, 50, &saveCount);
+		const SaveMetadata *saves = Save_GetSaveList(&saveCount);
 		if (saveCount == 0)
 		{
 			DrawText("No save files found", SCREEN_WIDTH / 2 - 120,
@@ -931,6 +1075,7 @@ void Game_Draw(void)
 	else if (currentState == STATE_DEATH_SCREEN)
 	{
 		World_Draw(&world);
+		Render_BeginHud();
 		DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, 200});
 		DrawText("YOU DIED", SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 - 50, 50,
 		         RED);
@@ -947,6 +1092,7 @@ void Game_Draw(void)
 				         SCREEN_HEIGHT - 100, 20, YELLOW);
 			}
 		}
+		Render_EndHud();
 	}
 	else if (currentState == STATE_CREDITS)
 	{
@@ -995,6 +1141,7 @@ void Game_Draw(void)
 		ClearBackground((Color){50, 50, 70, 255});
 		BeginMode2D(editor.camera);
 		Level_Draw(&editor.level, &editor.assets, editor.camera);
+		RenderQueue_Flush();
 		
 		// Draw player spawn indicator (blue circle with "P")
 		int spawnX = (int)editor.level.playerSpawn.x + TILE_SIZE / 2;
@@ -1403,26 +1550,19 @@ void Game_Draw(void)
 		char dropdownText[512] = "";
 		if (editor.totalLevelFiles > 0 && editor.currentLevelIndex >= 0)
 		{
-			const char *fname = GetFileNameWithoutExt(editor.levelFiles[editor.currentLevelIndex]);
-			snprintf(dropdownText, sizeof(dropdownText), "%s", fname);
+			const LevelManifestEntry *entry =
+			    Manifest_GetEntry(editor.currentLevelIndex);
+			snprintf(dropdownText, sizeof(dropdownText), "%s",
+			         entry ? entry->name : "");
 		}
 		else
 		{
 			strcpy(dropdownText, "New Level");
 		}
 		
-		// Build dropdown items list
-		char dropdownItems[8192] = "";
-		for (int i = 0; i < editor.totalLevelFiles && i < MAX_LEVELS; i++)
-		{
-			const char *fname = GetFileNameWithoutExt(editor.levelFiles[i]);
-			strcat(dropdownItems, fname);
-			if (i < editor.totalLevelFiles - 1)
-				strcat(dropdownItems, ";");
-		}
-		
+		// Dropdown items come prebuilt from the manifest
 		if (GuiDropdownBox((Rectangle){toolbarX + 50, toolbarY - 2, 200, 25}, 
-		                   dropdownItems, &editor.levelDropdownSelection, 
+		                   Manifest_GetNameList(), &editor.levelDropdownSelection, 
 		                   editor.levelDropdownActive))
 		{
 			editor.levelDropdownActive = !editor.levelDropdownActive;
@@ -1928,8 +2068,16 @@ void Game_Draw(void)
 	else if (currentState == STATE_PLAYING || currentState == STATE_PAUSED)
 	{
 		World_Draw(&world);
+		Render_BeginHud();
+		PROFILE_BEGIN(PROFILE_HUD);
 		DrawRectangle(0, 0, 360, 155, (Color){0, 0, 0, 200});
 		DrawText(TextFormat("FPS: %d", GetFPS()), 280, 125, 18, LIGHTGRAY);
+		if (Render_GetScale() < 1.0f)
+		{
+			DrawText(TextFormat("RES: %d%%",
+			                    (int)(Render_GetScale() * 100 + 0.5f)),
+			         270, 105, 18, LIGHTGRAY);
+		}
 		DrawText(TextFormat("Level: %d/%d", gameData.currentLevel + 1,
 		                    gameData.totalLevels),
 		         10, 10, 20, WHITE);
@@ -1949,15 +2097,20 @@ void Game_Draw(void)
 		{
 			Pause_Draw();
 		}
+		PROFILE_END(PROFILE_HUD);
+		Profiler_Draw();
+		Render_EndHud();
 	}
 	else if (currentState == STATE_LEVEL_COMPLETE)
 	{
 		World_Draw(&world);
+		Render_BeginHud();
 		DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, 150});
 		DrawText("LEVEL COMPLETE!", SCREEN_WIDTH / 2 - 140,
 		         SCREEN_HEIGHT / 2 - 40, 40, GOLD);
 		DrawText("Press ENTER to continue", SCREEN_WIDTH / 2 - 110,
 		         SCREEN_HEIGHT / 2 + 20, 20, WHITE);
+		Render_EndHud();
 	}
 	else if (currentState == STATE_GAME_COMPLETE)
 	{
@@ -2031,6 +2184,8 @@ void Game_Draw(void)
 			DrawText(ach->description, notifX + 20, notifY + 65, 14, textColor);
 		}
 	}
+	Mem_Draw();
+	Hitch_Draw();
 }
 void Game_Cleanup(void)
 {
@@ -2045,7 +2200,26 @@ void Game_Cleanup(void)
 		Level_Unload(&editor.level);
 		Assets_Unload(&editor.assets);
 	}
+	World_CancelPreload();
+	Game_UnloadMenuBackgrounds();
+	Render_Unload();
+	AssetCache_Shutdown();
+	Loader_Shutdown();
+	Manifest_Shutdown();
+	Pack_Close();
+	Atlas_Unload();
 	CloseAudioDevice();
+	Counters_Shutdown();
+	Hitch_Shutdown();
+	// Queued writes hold copies until they reach the disk, so wait for them
+	// before counting what is left. Static arrays live as long as the
+	// process; whatever is still counted after them was never freed.
+	Writer_Flush();
+	Mem_UntrackStatics();
+	Mem_Dump(MEM_DUMP_FILE);
+	// Last, so every save and the trace made up to here reach the disk.
+	Trace_Shutdown();
+	Writer_Shutdown();
 }
 const AchievementSystem *Game_GetAchievementSystem(void)
 {
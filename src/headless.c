@@ -0,0 +1,64 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifdef CIRNO_HEADLESS
+// The few raylib functions the simulation code calls, for builds with
+// -DCIRNO_HEADLESS that link no raylib at all. raylib.h is still included
+// for its types and declarations; nothing here needs a window.
+#include "raylib.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+// Warnings and errors only; the simulation has no use for info chatter.
+void TraceLog(int logLevel, const char *text, ...)
+{
+	if (logLevel < LOG_WARNING)
+		return;
+	va_list args;
+	va_start(args, text);
+	vfprintf(stderr, text, args);
+	va_end(args);
+	fputc('\n', stderr);
+}
+bool FileExists(const char *fileName)
+{
+	FILE *f = fopen(fileName, "rb");
+	if (!f)
+		return false;
+	fclose(f);
+	return true;
+}
+// The same CRC-32 raylib computes, so level files written by either build
+// check out in the other.
+unsigned int ComputeCRC32(unsigned char *data, int dataSize)
+{
+	unsigned int crc = 0xFFFFFFFFu;
+	for (int i = 0; i < dataSize; i++)
+	{
+		crc ^= data[i];
+		for (int bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+	}
+	return ~crc;
+}
+bool CheckCollisionRecs(Rectangle rec1, Rectangle rec2)
+{
+	return rec1.x < rec2.x + rec2.width && rec1.x + rec1.width > rec2.x &&
+	       rec1.y < rec2.y + rec2.height && rec1.y + rec1.height > rec2.y;
+}
+#endif
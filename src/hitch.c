@@ -0,0 +1,221 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hitch.h"
+#include "config.h"
+#include "loader.h"
+#include "memtrack.h"
+#include "profiler.h"
+#include "writer.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Room kept at the end of the log for the summary written at exit.
+#define HITCH_SUMMARY_BYTES 4096
+// Histogram range drawn by the overlay; slower frames are only counted.
+#define HITCH_GRAPH_MS 50.0f
+
+static unsigned long histogram[HITCH_BUCKETS];
+static unsigned long frameCount = 0;
+static double totalTime = 0.0;
+static float thresholdMs = HITCH_THRESHOLD_MS;
+static int hitchCount = 0;
+static float worstMs = 0.0f;
+static char hitchLog[HITCH_MAX_BYTES];
+static int logLength = 0;
+static bool logFull = false;
+static bool logDirty = false;
+static float sinceWrite = 0.0f;
+static bool visible = false;
+
+static void Hitch_Print(int limit, const char *format, ...)
+{
+	int room = limit - logLength;
+	if (room <= 1)
+		return;
+	va_list args;
+	va_start(args, format);
+	int written = vsnprintf(hitchLog + logLength, room, format, args);
+	va_end(args);
+	if (written > 0)
+		logLength += written < room ? written : room - 1;
+}
+static void Hitch_Log(float frameMs, const HitchContext *context)
+{
+	int limit = HITCH_MAX_BYTES - HITCH_SUMMARY_BYTES;
+	if (logFull)
+		return;
+	if (logLength > limit - 1024)
+	{
+		Hitch_Print(limit, "log full, later hitches are only counted\n");
+		logFull = true;
+		return;
+	}
+	Hitch_Print(limit,
+	            "%.2f s: %.1f ms, %s, %d bullets, %d collectibles, "
+	            "%d spawners\n",
+	            totalTime, frameMs, context->state, context->bullets,
+	            context->collectibles, context->spawners);
+	char paths[512];
+	int loads = Loader_DescribePending(paths, sizeof(paths));
+	if (loads > 0)
+		Hitch_Print(limit, "  loading %d: %s\n", loads, paths);
+	int writes = Writer_DescribePending(paths, sizeof(paths));
+	if (writes > 0)
+		Hitch_Print(limit, "  writing %d: %s\n", writes, paths);
+	// Release builds compile the profiler out, so there are no sections.
+	float sections[PROFILE_SECTION_COUNT];
+	if (Profiler_GetLastFrame(sections))
+	{
+		float timed = 0.0f;
+		Hitch_Print(limit, "  ms:");
+		for (int i = 0; i < PROFILE_SECTION_COUNT; i++)
+		{
+			timed += sections[i];
+			if (sections[i] >= 0.01f)
+				Hitch_Print(limit, " %s %.2f,",
+				            Profiler_GetSectionName((ProfileSection)i),
+				            sections[i]);
+		}
+		Hitch_Print(limit, " untimed %.2f\n", frameMs - timed);
+	}
+}
+static void Hitch_Write(void)
+{
+	Writer_Submit(HITCH_FILE, hitchLog, logLength);
+	logDirty = false;
+	sinceWrite = 0.0f;
+}
+void Hitch_Init(void)
+{
+	const char *env = getenv("CIRNO_HITCH_MS");
+	if (env && atof(env) > 0.0)
+		thresholdMs = (float)atof(env);
+	Mem_TrackStatic(MEM_TAG_OTHER, sizeof(hitchLog) + sizeof(histogram));
+	Hitch_Print(HITCH_MAX_BYTES, "frames over %.1f ms\n", thresholdMs);
+}
+// Adds the histogram and the lows, then writes the log one last time.
+void Hitch_Shutdown(void)
+{
+	Hitch_Print(HITCH_MAX_BYTES,
+	            "\n%lu frames, %.0f fps average, 1%% low %.0f fps, "
+	            "0.1%% low %.0f fps, %d hitches, worst %.1f ms\n",
+	            frameCount, totalTime > 0.0 ? frameCount / totalTime : 0.0,
+	            Hitch_GetLowFps(0.01f), Hitch_GetLowFps(0.001f), hitchCount,
+	            worstMs);
+	for (int i = 0; i < HITCH_BUCKETS; i++)
+	{
+		if (histogram[i] > 0)
+			Hitch_Print(HITCH_MAX_BYTES, "%6.1f ms%s %lu\n",
+			            i * HITCH_BUCKET_MS,
+			            i == HITCH_BUCKETS - 1 ? "+" : " ", histogram[i]);
+	}
+	Hitch_Write();
+}
+// A frame over the threshold is logged with whatever the game is doing at
+// the start of the next update, which is when its length is known.
+void Hitch_NewFrame(float frameTime, const HitchContext *context)
+{
+	if (frameTime <= 0.0f)
+		return;
+	float frameMs = frameTime * 1000.0f;
+	int bucket = (int)(frameMs / HITCH_BUCKET_MS);
+	histogram[bucket < HITCH_BUCKETS ? bucket : HITCH_BUCKETS - 1]++;
+	frameCount++;
+	totalTime += frameTime;
+	if (frameMs > thresholdMs)
+	{
+		hitchCount++;
+		if (frameMs > worstMs)
+			worstMs = frameMs;
+		Hitch_Log(frameMs, context);
+		logDirty = true;
+	}
+	sinceWrite += frameTime;
+	if (logDirty && sinceWrite >= HITCH_WRITE_INTERVAL)
+		Hitch_Write();
+}
+// The frame rate of the slowest `fraction` of frames so far: 0.01 gives
+// the 1% low. Accurate to a histogram bucket.
+float Hitch_GetLowFps(float fraction)
+{
+	if (frameCount == 0)
+		return 0.0f;
+	unsigned long target = (unsigned long)(frameCount * fraction);
+	if (target < 1)
+		target = 1;
+	unsigned long seen = 0;
+	for (int i = HITCH_BUCKETS - 1; i >= 0; i--)
+	{
+		seen += histogram[i];
+		if (seen >= target)
+			return 1000.0f / ((i + 1) * HITCH_BUCKET_MS);
+	}
+	return 0.0f;
+}
+void Hitch_Toggle(void) { visible = !visible; }
+// Drawn in screen coordinates, bottom left. Bar heights are on a log scale
+// so a handful of slow frames still shows next to thousands of fast ones.
+void Hitch_Draw(void)
+{
+	if (!visible)
+		return;
+	const int width = 240;
+	const int graphHeight = 60;
+	const int x = 10;
+	const int y = SCREEN_HEIGHT - graphHeight - 50;
+	DrawRectangle(x - 5, y - 5, width + 10, graphHeight + 50,
+	              (Color){0, 0, 0, 200});
+	DrawText(TextFormat("%.0f fps avg, 1%% low %.0f, 0.1%% low %.0f",
+	                    totalTime > 0.0 ? frameCount / totalTime : 0.0,
+	                    Hitch_GetLowFps(0.01f), Hitch_GetLowFps(0.001f)),
+	         x, y, 12, WHITE);
+	DrawText(TextFormat("%d hitches over %.1f ms, worst %.1f ms",
+	                    hitchCount, thresholdMs, worstMs),
+	         x, y + 14, 12, LIGHTGRAY);
+	int graphY = y + 30;
+	int shown = (int)(HITCH_GRAPH_MS / HITCH_BUCKET_MS);
+	if (shown > HITCH_BUCKETS)
+		shown = HITCH_BUCKETS;
+	unsigned long most = 1;
+	for (int i = 0; i < shown; i++)
+		if (histogram[i] > most)
+			most = histogram[i];
+	float barWidth = (float)width / shown;
+	float scale = graphHeight / logf(1.0f + most);
+	for (int i = 0; i < shown; i++)
+	{
+		if (histogram[i] == 0)
+			continue;
+		float bucketMs = i * HITCH_BUCKET_MS;
+		Color color = bucketMs >= thresholdMs          ? RED
+		              : bucketMs >= 1000.0f / TARGET_FPS ? ORANGE
+		                                                 : GREEN;
+		int height = (int)(logf(1.0f + histogram[i]) * scale) + 1;
+		DrawRectangle(x + (int)(i * barWidth), graphY + graphHeight - height,
+		              barWidth > 1.0f ? (int)barWidth : 1, height, color);
+	}
+	int budgetX = x + (int)(1000.0f / TARGET_FPS / HITCH_BUCKET_MS * barWidth);
+	DrawLine(budgetX, graphY, budgetX, graphY + graphHeight,
+	         (Color){255, 255, 255, 120});
+	DrawText("0", x, graphY + graphHeight + 2, 10, GRAY);
+	DrawText(TextFormat("%.0f ms", HITCH_GRAPH_MS), x + width - 30,
+	         graphY + graphHeight + 2, 10, GRAY);
+}
@@ -0,0 +1,21 @@
+#ifndef HITCH_H
+#define HITCH_H
+// Frame-time histogram with 1% and 0.1% lows, plus a log of every frame
+// slower than HITCH_THRESHOLD_MS (or CIRNO_HITCH_MS from the environment).
+// Each log entry has the profiler sections, the game state, the entity
+// counts and the files being loaded or written. F7 shows the histogram;
+// the log is written to HITCH_FILE.
+typedef struct
+{
+	const char *state;
+	int bullets;
+	int collectibles;
+	int spawners;
+} HitchContext;
+void Hitch_Init(void);
+void Hitch_Shutdown(void);
+void Hitch_NewFrame(float frameTime, const HitchContext *context);
+float Hitch_GetLowFps(float fraction);
+void Hitch_Toggle(void);
+void Hitch_Draw(void);
+#endif
@@ -17,19 +17,67 @@
  */
 
 #include "level.h"
+#include "atlas.h"
+#include "counters.h"
+#include "manifest.h"
+#include "memtrack.h"
+#include "pack.h"
+#include "renderqueue.h"
+#include "writer.h"
 #include "config.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-// Comparison function for sorting level filenames
-static int CompareFilenames(const void *a, const void *b)
+// Sets every field to its blank-level value without allocating anything.
+static void Level_Reset(Level *lvl, int width, int height)
 {
-	const char *str_a = (const char *)a;
-	const char *str_b = (const char *)b;
-	return strcmp(str_a, str_b);
+	lvl->width = width;
+	lvl->height = height;
+	lvl->playerSpawn = (Vector2){100, 100};
+	lvl->goalPos = (Vector2){0, 0};
+	lvl->hasGoal = false;
+	lvl->musicFile[0] = '\0';
+	lvl->hasVisualNovel = false;
+	lvl->dialogueCount = 0;
+	lvl->tiles = NULL;
+	lvl->backgroundTiles = NULL;
+	lvl->tilesMapped = false;
+	lvl->backgroundMapped = false;
+	memset(&lvl->mapping, 0, sizeof(lvl->mapping));
+}
+static int **Level_AllocLayer(int width, int height)
+{
+	int **layer = (int **)Mem_Alloc(MEM_TAG_LEVEL, height * sizeof(int *));
+	if (!layer)
+		return NULL;
+	for (int y = 0; y < height; y++)
+	{
+		layer[y] = (int *)Mem_Calloc(MEM_TAG_LEVEL, width, sizeof(int));
+		if (!layer[y])
+		{
+			// Cleanup on failure
+			for (int j = 0; j < y; j++)
+				Mem_Free(layer[j]);
+			Mem_Free(layer);
+			return NULL;
+		}
+	}
+	return layer;
+}
+// Mapped layers only own their row table; the rows live in the mapping.
+static void Level_FreeLayer(int **layer, int height, bool mapped)
+{
+	if (!layer)
+		return;
+	if (!mapped)
+	{
+		for (int y = 0; y < height; y++)
+			Mem_Free(layer[y]);
+	}
+	Mem_Free(layer);
 }
-
 void Level_Create(Level *lvl, int width, int height)
 {
 	if (width < MIN_WORLD_WIDTH)
@@ -40,187 +88,611 @@ void Level_Create(Level *lvl, int width, int height)
 		width = MAX_WORLD_WIDTH;
 	if (height > MAX_WORLD_HEIGHT)
 		height = MAX_WORLD_HEIGHT;
-	lvl->width = width;
-	lvl->height = height;
-	lvl->playerSpawn = (Vector2){100, 100};
-	lvl->hasGoal = false;
-	lvl->musicFile[0] = '\0';
-	lvl->hasVisualNovel = false;
-	lvl->dialogueCount = 0;
-	lvl->tiles = (int **)malloc(lvl->height * sizeof(int *));
-	lvl->backgroundTiles = (int **)malloc(lvl->height * sizeof(int *));
+	Level_Reset(lvl, width, height);
+	lvl->tiles = Level_AllocLayer(width, height);
+	lvl->backgroundTiles = Level_AllocLayer(width, height);
 	if (!lvl->tiles || !lvl->backgroundTiles)
 	{
-		if (lvl->tiles) free(lvl->tiles);
-		if (lvl->backgroundTiles) free(lvl->backgroundTiles);
-		return;
+		Level_FreeLayer(lvl->tiles, height, false);
+		Level_FreeLayer(lvl->backgroundTiles, height, false);
+		lvl->tiles = NULL;
+		lvl->backgroundTiles = NULL;
 	}
-	for (int y = 0; y < lvl->height; y++)
+}
+#ifndef CIRNO_HEADLESS
+int Level_CountFiles(void) { return Manifest_GetCount(); }
+#endif
+// Level file v2, all integers little-endian:
+//   header    "CLVL", u16 version, u16 section count, u32 file size,
+//             u32 CRC-32 of everything after the header
+//   sections  u32 id, u32 offset, u32 size for each section
+// INFO holds the fixed fields and the music name, DLGS the visual novel
+// lines with length-prefixed strings, and TILE/BGTL the two layers. A
+// layer starts with an encoding byte: runs of (u16 count, u8 or u16 tile
+// id), or RAW32 with three pad bytes and then one i32 per tile. Sections
+// start on 4-byte boundaries so RAW32 data can be read as ints in place.
+// Files without the magic are the original raw struct dump (v1).
+#define LEVEL_MAGIC "CLVL"
+#define LEVEL_HEADER_SIZE 16
+#define LEVEL_SECTION_ENTRY_SIZE 12
+#define LEVEL_SECTION_COUNT 4
+#define LEVEL_SECTION_INFO 0x4F464E49u // "INFO"
+#define LEVEL_SECTION_DLGS 0x53474C44u // "DLGS"
+#define LEVEL_SECTION_TILE 0x454C4954u // "TILE"
+#define LEVEL_SECTION_BGTL 0x4C544742u // "BGTL"
+#define LEVEL_V1_DIALOGUE_SIZE 356
+#define LEVEL_LAYER_RAW32 0
+#define LEVEL_LAYER_RLE8 1
+#define LEVEL_LAYER_RLE16 2
+
+typedef struct
+{
+	unsigned char *data;
+	int size;
+	int capacity;
+} LevelWriter;
+
+typedef struct
+{
+	const unsigned char *data;
+	int size;
+	int pos;
+	bool failed;
+} LevelReader;
+
+static void LevelWriter_Put(LevelWriter *w, const void *src, int count)
+{
+	if (w->size + count > w->capacity)
+		return;
+	memcpy(w->data + w->size, src, count);
+	w->size += count;
+}
+static void LevelWriter_PutU8(LevelWriter *w, unsigned int value)
+{
+	unsigned char b = (unsigned char)value;
+	LevelWriter_Put(w, &b, 1);
+}
+static void LevelWriter_PutU16(LevelWriter *w, unsigned int value)
+{
+	LevelWriter_PutU8(w, value);
+	LevelWriter_PutU8(w, value >> 8);
+}
+static void LevelWriter_PutU32(LevelWriter *w, unsigned int value)
+{
+	LevelWriter_PutU16(w, value);
+	LevelWriter_PutU16(w, value >> 16);
+}
+static void LevelWriter_PutF32(LevelWriter *w, float value)
+{
+	unsigned int bits;
+	memcpy(&bits, &value, sizeof(bits));
+	LevelWriter_PutU32(w, bits);
+}
+static void LevelWriter_SetU32(LevelWriter *w, int pos, unsigned int value)
+{
+	w->data[pos] = (unsigned char)value;
+	w->data[pos + 1] = (unsigned char)(value >> 8);
+	w->data[pos + 2] = (unsigned char)(value >> 16);
+	w->data[pos + 3] = (unsigned char)(value >> 24);
+}
+// Strings are stored without padding, prefixed by their length.
+static void LevelWriter_PutString(LevelWriter *w, const char *text,
+                                  int maxLength, bool wide)
+{
+	int length = 0;
+	while (length < maxLength - 1 && text[length] != '\0')
+		length++;
+	if (wide)
+		LevelWriter_PutU16(w, length);
+	else
+		LevelWriter_PutU8(w, length);
+	LevelWriter_Put(w, text, length);
+}
+static void LevelReader_Get(LevelReader *r, void *dst, int count)
+{
+	if (r->failed || count < 0 || r->pos + count > r->size)
 	{
-		lvl->tiles[y] = (int *)calloc(lvl->width, sizeof(int));
-		lvl->backgroundTiles[y] = (int *)calloc(lvl->width, sizeof(int));
-		if (!lvl->tiles[y] || !lvl->backgroundTiles[y])
-		{
-			// Cleanup on failure
-			for (int j = 0; j <= y; j++)
-			{
-				if (lvl->tiles[j]) free(lvl->tiles[j]);
-				if (lvl->backgroundTiles[j]) free(lvl->backgroundTiles[j]);
-			}
-			free(lvl->tiles);
-			free(lvl->backgroundTiles);
-			return;
-		}
+		r->failed = true;
+		memset(dst, 0, count > 0 ? count : 0);
+		return;
 	}
+	memcpy(dst, r->data + r->pos, count);
+	r->pos += count;
+}
+static unsigned int LevelReader_GetU8(LevelReader *r)
+{
+	unsigned char b;
+	LevelReader_Get(r, &b, 1);
+	return b;
 }
-int Level_CountFiles(void)
+static unsigned int LevelReader_GetU16(LevelReader *r)
 {
-	FilePathList files = LoadDirectoryFiles("assets/levels");
-	int count = 0;
-	for (unsigned int i = 0; i < files.count; i++)
+	unsigned int lo = LevelReader_GetU8(r);
+	return lo | (LevelReader_GetU8(r) << 8);
+}
+static unsigned int LevelReader_GetU32(LevelReader *r)
+{
+	unsigned int lo = LevelReader_GetU16(r);
+	return lo | (LevelReader_GetU16(r) << 16);
+}
+static float LevelReader_GetF32(LevelReader *r)
+{
+	unsigned int bits = LevelReader_GetU32(r);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+static void LevelReader_GetString(LevelReader *r, char *text, int maxLength,
+                                  bool wide)
+{
+	int length = wide ? LevelReader_GetU16(r) : LevelReader_GetU8(r);
+	if (length >= maxLength)
 	{
-		const char *ext = GetFileExtension(files.paths[i]);
-		if (TextIsEqual(ext, ".lvl"))
-		{
-			count++;
-		}
+		r->failed = true;
+		length = 0;
 	}
-	UnloadDirectoryFiles(files);
-	return count;
+	LevelReader_Get(r, text, length);
+	text[length] = '\0';
 }
-void Level_LoadFromFile(Level *lvl, const char *filepath)
+// Mostly empty layers are stored as runs. A layer that runs do not shrink
+// to under half its plain size is stored as little-endian ints instead,
+// since that form can be used straight out of the mapped file.
+static void Level_PutLayer(LevelWriter *w, int **layer, int width, int height)
 {
-	FILE *f = fopen(filepath, "rb");
-	if (!f)
+	bool wide = false;
+	int runs = 0;
+	int total = width * height;
+	for (int i = 0; i < total; i++)
 	{
-		Level_Create(lvl, 30, 20);
+		int value = layer[i / width][i % width];
+		if (value < 0 || value > 255)
+			wide = true;
+		if (i == 0 || value != layer[(i - 1) / width][(i - 1) % width] ||
+		    i % 0xFFFF == 0)
+			runs++;
+	}
+	if (2 * (1 + runs * (wide ? 4 : 3)) > 4 + total * 4)
+	{
+		LevelWriter_PutU32(w, LEVEL_LAYER_RAW32); // id byte plus padding
+		for (int i = 0; i < total; i++)
+			LevelWriter_PutU32(w, layer[i / width][i % width]);
 		return;
 	}
-	fread(&lvl->width, sizeof(int), 1, f);
-	fread(&lvl->height, sizeof(int), 1, f);
-	fread(&lvl->playerSpawn, sizeof(Vector2), 1, f);
-	fread(&lvl->goalPos, sizeof(Vector2), 1, f);
-	fread(&lvl->hasGoal, sizeof(bool), 1, f);
-	fread(lvl->musicFile, sizeof(char), 256, f);
-	fread(&lvl->hasVisualNovel, sizeof(bool), 1, f);
-	fread(&lvl->dialogueCount, sizeof(int), 1, f);
-	if (lvl->hasVisualNovel && lvl->dialogueCount > 0)
+	LevelWriter_PutU8(w, wide ? LEVEL_LAYER_RLE16 : LEVEL_LAYER_RLE8);
+	int i = 0;
+	while (i < total)
 	{
-		fread(lvl->dialogues, sizeof(VNDialogue), lvl->dialogueCount, f);
+		int value = layer[i / width][i % width];
+		int run = 1;
+		while (i + run < total && run < 0xFFFF &&
+		       layer[(i + run) / width][(i + run) % width] == value)
+			run++;
+		LevelWriter_PutU16(w, run);
+		if (wide)
+			LevelWriter_PutU16(w, value);
+		else
+			LevelWriter_PutU8(w, value);
+		i += run;
 	}
-	lvl->tiles = (int **)malloc(lvl->height * sizeof(int *));
-	lvl->backgroundTiles = (int **)malloc(lvl->height * sizeof(int *));
-	if (!lvl->tiles || !lvl->backgroundTiles)
+}
+static bool Level_IsLittleEndian(void)
+{
+	unsigned int one = 1;
+	return *(unsigned char *)&one == 1;
+}
+// A RAW32 layer in a mapped file is used in place: only the row table is
+// allocated and the OS copies a page the first time the editor writes to
+// it. Everything else is decoded into freshly allocated rows.
+static bool Level_GetLayer(LevelReader *r, unsigned char *mapped,
+                           int ***layer, bool *isMapped, int width,
+                           int height)
+{
+	unsigned int encoding = LevelReader_GetU8(r);
+	int total = width * height;
+	if (encoding == LEVEL_LAYER_RAW32)
 	{
-		if (lvl->tiles) free(lvl->tiles);
-		if (lvl->backgroundTiles) free(lvl->backgroundTiles);
-		fclose(f);
-		Level_Create(lvl, 30, 20);
-		return;
+		r->pos = 4;
+		if (r->size != 4 + total * 4)
+			return false;
+		if (mapped && Level_IsLittleEndian() &&
+		    (uintptr_t)(mapped + 4) % sizeof(int) == 0)
+		{
+			int **rows =
+			    (int **)Mem_Alloc(MEM_TAG_LEVEL, height * sizeof(int *));
+			if (!rows)
+				return false;
+			for (int y = 0; y < height; y++)
+				rows[y] = (int *)(mapped + 4) + y * width;
+			*layer = rows;
+			*isMapped = true;
+			return true;
+		}
 	}
-	for (int y = 0; y < lvl->height; y++)
+	else if (encoding != LEVEL_LAYER_RLE8 && encoding != LEVEL_LAYER_RLE16)
+	{
+		return false;
+	}
+	*layer = Level_AllocLayer(width, height);
+	if (!*layer)
+		return false;
+	int filled = 0;
+	while (filled < total && !r->failed)
 	{
-		lvl->tiles[y] = (int *)malloc(lvl->width * sizeof(int));
-		lvl->backgroundTiles[y] = (int *)malloc(lvl->width * sizeof(int));
-		if (!lvl->tiles[y] || !lvl->backgroundTiles[y])
+		int run = 1;
+		int value;
+		if (encoding == LEVEL_LAYER_RAW32)
 		{
-			// Cleanup on failure
-			for (int j = 0; j <= y; j++)
-			{
-				if (lvl->tiles[j]) free(lvl->tiles[j]);
-				if (lvl->backgroundTiles[j]) free(lvl->backgroundTiles[j]);
-			}
-			free(lvl->tiles);
-			free(lvl->backgroundTiles);
-			fclose(f);
-			Level_Create(lvl, 30, 20);
-			return;
+			value = (int)LevelReader_GetU32(r);
+		}
+		else
+		{
+			run = (int)LevelReader_GetU16(r);
+			value = (int)(encoding == LEVEL_LAYER_RLE16 ? LevelReader_GetU16(r)
+			                                            : LevelReader_GetU8(r));
 		}
-		fread(lvl->tiles[y], sizeof(int), lvl->width, f);
-		fread(lvl->backgroundTiles[y], sizeof(int), lvl->width, f);
+		if (run == 0 || filled + run > total)
+			return false;
+		for (int i = filled; i < filled + run; i++)
+			(*layer)[i / width][i % width] = value;
+		filled += run;
 	}
-	fclose(f);
+	return !r->failed && r->pos == r->size;
 }
-void Level_SaveToFile(const Level *lvl, const char *filepath)
+// Creates the level's grids once the size is known to be sane; Level_Create
+// would otherwise clamp a corrupt size into something that looks valid.
+static bool Level_Allocate(Level *lvl, int width, int height)
 {
-	FILE *f = fopen(filepath, "wb");
-	if (!f)
-		return;
-	fwrite(&lvl->width, sizeof(int), 1, f);
-	fwrite(&lvl->height, sizeof(int), 1, f);
-	fwrite(&lvl->playerSpawn, sizeof(Vector2), 1, f);
-	fwrite(&lvl->goalPos, sizeof(Vector2), 1, f);
-	fwrite(&lvl->hasGoal, sizeof(bool), 1, f);
-	fwrite(lvl->musicFile, sizeof(char), 256, f);
-	fwrite(&lvl->hasVisualNovel, sizeof(bool), 1, f);
-	fwrite(&lvl->dialogueCount, sizeof(int), 1, f);
-	if (lvl->hasVisualNovel && lvl->dialogueCount > 0)
+	if (width < MIN_WORLD_WIDTH || width > MAX_WORLD_WIDTH ||
+	    height < MIN_WORLD_HEIGHT || height > MAX_WORLD_HEIGHT)
+		return false;
+	Level_Create(lvl, width, height);
+	return lvl->tiles != NULL;
+}
+static bool Level_DecodeV1(Level *lvl, const unsigned char *data, int size,
+                           bool headerOnly)
+{
+	LevelReader r = {data, size, 0, false};
+	int width = (int)LevelReader_GetU32(&r);
+	int height = (int)LevelReader_GetU32(&r);
+	Vector2 spawn, goal;
+	spawn.x = LevelReader_GetF32(&r);
+	spawn.y = LevelReader_GetF32(&r);
+	goal.x = LevelReader_GetF32(&r);
+	goal.y = LevelReader_GetF32(&r);
+	bool hasGoal = LevelReader_GetU8(&r) != 0;
+	char musicFile[256];
+	LevelReader_Get(&r, musicFile, 256);
+	musicFile[255] = '\0';
+	bool hasVisualNovel = LevelReader_GetU8(&r) != 0;
+	int dialogueCount = (int)LevelReader_GetU32(&r);
+	if (r.failed || dialogueCount < 0 || dialogueCount > 20)
+		return false;
+	int dialogueBytes =
+	    hasVisualNovel ? dialogueCount * LEVEL_V1_DIALOGUE_SIZE : 0;
+	if (width < MIN_WORLD_WIDTH || width > MAX_WORLD_WIDTH ||
+	    height < MIN_WORLD_HEIGHT || height > MAX_WORLD_HEIGHT ||
+	    r.pos + dialogueBytes + width * height * 8 != size)
+		return false;
+	if (headerOnly)
+		Level_Reset(lvl, width, height);
+	else if (!Level_Allocate(lvl, width, height))
+		return false;
+	lvl->playerSpawn = spawn;
+	lvl->goalPos = goal;
+	lvl->hasGoal = hasGoal;
+	strcpy(lvl->musicFile, musicFile);
+	lvl->hasVisualNovel = hasVisualNovel;
+	lvl->dialogueCount = dialogueCount;
+	if (headerOnly)
+		return true;
+	for (int i = 0; i < dialogueBytes / LEVEL_V1_DIALOGUE_SIZE; i++)
 	{
-		fwrite(lvl->dialogues, sizeof(VNDialogue), lvl->dialogueCount, f);
+		VNDialogue *d = &lvl->dialogues[i];
+		LevelReader_Get(&r, d->characterName, 32);
+		LevelReader_Get(&r, d->text, 256);
+		LevelReader_Get(&r, d->characterSprite, 64);
+		d->bgColor = (int)LevelReader_GetU32(&r);
+		d->characterName[31] = '\0';
+		d->text[255] = '\0';
+		d->characterSprite[63] = '\0';
 	}
-	for (int y = 0; y < lvl->height; y++)
+	for (int y = 0; y < height; y++)
 	{
-		fwrite(lvl->tiles[y], sizeof(int), lvl->width, f);
-		fwrite(lvl->backgroundTiles[y], sizeof(int), lvl->width, f);
+		for (int x = 0; x < width; x++)
+			lvl->tiles[y][x] = (int)LevelReader_GetU32(&r);
+		for (int x = 0; x < width; x++)
+			lvl->backgroundTiles[y][x] = (int)LevelReader_GetU32(&r);
 	}
-	fclose(f);
+	return true;
 }
-void Level_Load(Level *lvl, int index)
+static bool Level_DecodeV2(Level *lvl, unsigned char *data, int size,
+                           bool canMap, bool headerOnly)
 {
-	FilePathList files = LoadDirectoryFiles("assets/levels");
-	int levelCount = 0;
-	char levelFiles[MAX_LEVELS][256];
-	
-	// Collect all .lvl files
-	for (unsigned int i = 0; i < files.count && levelCount < MAX_LEVELS; i++)
+	LevelReader r = {data, size, 4, false};
+	unsigned int version = LevelReader_GetU16(&r);
+	unsigned int sectionCount = LevelReader_GetU16(&r);
+	unsigned int fileSize = LevelReader_GetU32(&r);
+	unsigned int crc = LevelReader_GetU32(&r);
+	if (r.failed || version != LEVEL_FORMAT_VERSION ||
+	    fileSize != (unsigned int)size || sectionCount > 16)
+		return false;
+	if (ComputeCRC32((unsigned char *)data + LEVEL_HEADER_SIZE,
+	                 size - LEVEL_HEADER_SIZE) != crc)
+		return false;
+	LevelReader info = {0}, dialogues = {0}, tiles = {0}, background = {0};
+	int tableEnd = LEVEL_HEADER_SIZE + sectionCount * LEVEL_SECTION_ENTRY_SIZE;
+	for (unsigned int i = 0; i < sectionCount; i++)
 	{
-		const char *ext = GetFileExtension(files.paths[i]);
-		if (TextIsEqual(ext, ".lvl"))
+		unsigned int id = LevelReader_GetU32(&r);
+		unsigned int offset = LevelReader_GetU32(&r);
+		unsigned int length = LevelReader_GetU32(&r);
+		if (r.failed || offset < (unsigned int)tableEnd ||
+		    offset > (unsigned int)size || length > size - offset)
+			return false;
+		LevelReader section = {data + offset, (int)length, 0, false};
+		if (id == LEVEL_SECTION_INFO)
+			info = section;
+		else if (id == LEVEL_SECTION_DLGS)
+			dialogues = section;
+		else if (id == LEVEL_SECTION_TILE)
+			tiles = section;
+		else if (id == LEVEL_SECTION_BGTL)
+			background = section;
+	}
+	if (!info.data || !tiles.data)
+		return false;
+	int width = (int)LevelReader_GetU32(&info);
+	int height = (int)LevelReader_GetU32(&info);
+	Vector2 spawn, goal;
+	spawn.x = LevelReader_GetF32(&info);
+	spawn.y = LevelReader_GetF32(&info);
+	goal.x = LevelReader_GetF32(&info);
+	goal.y = LevelReader_GetF32(&info);
+	bool hasGoal = LevelReader_GetU8(&info) != 0;
+	bool hasVisualNovel = LevelReader_GetU8(&info) != 0;
+	char musicFile[256];
+	LevelReader_GetString(&info, musicFile, 256, false);
+	if (info.failed)
+		return false;
+	if (width < MIN_WORLD_WIDTH || width > MAX_WORLD_WIDTH ||
+	    height < MIN_WORLD_HEIGHT || height > MAX_WORLD_HEIGHT)
+		return false;
+	Level_Reset(lvl, width, height);
+	lvl->playerSpawn = spawn;
+	lvl->goalPos = goal;
+	lvl->hasGoal = hasGoal;
+	strcpy(lvl->musicFile, musicFile);
+	lvl->hasVisualNovel = hasVisualNovel;
+	if (headerOnly)
+		return true;
+	if (dialogues.data)
+	{
+		int count = (int)LevelReader_GetU8(&dialogues);
+		if (count > 20)
+			count = 20;
+		for (int i = 0; i < count && !dialogues.failed; i++)
 		{
-			strncpy(levelFiles[levelCount], files.paths[i], 255);
-			levelFiles[levelCount][255] = '\0';
-			levelCount++;
+			VNDialogue *d = &lvl->dialogues[i];
+			LevelReader_GetString(&dialogues, d->characterName, 32, false);
+			LevelReader_GetString(&dialogues, d->text, 256, true);
+			LevelReader_GetString(&dialogues, d->characterSprite, 64, false);
+			d->bgColor = (int)LevelReader_GetU8(&dialogues);
 		}
+		lvl->dialogueCount = count;
 	}
-	UnloadDirectoryFiles(files);
-	
-	// Sort level files alphabetically
-	if (levelCount > 0)
+	bool ok = !dialogues.failed &&
+	          Level_GetLayer(&tiles, canMap ? data + (tiles.data - data) : NULL,
+	                         &lvl->tiles, &lvl->tilesMapped, width, height);
+	if (ok && background.data)
+		ok = Level_GetLayer(
+		    &background, canMap ? data + (background.data - data) : NULL,
+		    &lvl->backgroundTiles, &lvl->backgroundMapped, width, height);
+	else if (ok)
+		ok = (lvl->backgroundTiles = Level_AllocLayer(width, height)) != NULL;
+	if (!ok)
+		Level_Unload(lvl);
+	return ok;
+}
+static bool Level_Decode(Level *lvl, unsigned char *data, int size,
+                         bool canMap, bool headerOnly)
+{
+	if (size >= LEVEL_HEADER_SIZE && memcmp(data, LEVEL_MAGIC, 4) == 0)
+		return Level_DecodeV2(lvl, data, size, canMap, headerOnly);
+	return Level_DecodeV1(lvl, data, size, headerOnly);
+}
+// Borrows the packed copy, or maps the loose file that overrides it or is
+// not packed at all. Packed data is shared by every load, so it is never
+// used in place.
+static bool Level_OpenData(const char *filepath, MappedFile *map,
+                           unsigned char **data, int *size, bool *canMap)
+{
+	memset(map, 0, sizeof(MappedFile));
+	*data = (unsigned char *)Pack_Find(filepath, size);
+	*canMap = false;
+	if (*data)
+		return true;
+	*canMap = FileExists(filepath) && MapFile_Open(map, filepath);
+	*data = map->data;
+	*size = map->size;
+	return *canMap;
+}
+// Leaves lvl without layers and returns false when the file is missing or
+// does not decode.
+bool Level_TryLoadFromFile(Level *lvl, const char *filepath)
+{
+	MappedFile map;
+	unsigned char *data;
+	int size = 0;
+	bool canMap;
+	bool opened = Level_OpenData(filepath, &map, &data, &size, &canMap);
+	bool ok = opened && Level_Decode(lvl, data, size, canMap, false);
+	if (ok && (lvl->tilesMapped || lvl->backgroundMapped))
+		lvl->mapping = map;
+	else
+		MapFile_Close(&map);
+	if (opened && !ok)
+		TraceLog(LOG_WARNING, "LEVEL: %s is corrupt", filepath);
+	return ok;
+}
+void Level_LoadFromFile(Level *lvl, const char *filepath)
+{
+	if (!Level_TryLoadFromFile(lvl, filepath))
+		Level_Create(lvl, 30, 20);
+}
+void Level_SaveToFile(const Level *lvl, const char *filepath)
+{
+	// Worst case: both layers stored RAW32, plus section alignment.
+	int capacity = LEVEL_HEADER_SIZE +
+	               LEVEL_SECTION_COUNT * LEVEL_SECTION_ENTRY_SIZE + 512 +
+	               20 * (1 + 32 + 2 + 256 + 1 + 64 + 1) + 1 +
+	               2 * (4 + lvl->width * lvl->height * 4) +
+	               LEVEL_SECTION_COUNT * 3;
+	LevelWriter w = {(unsigned char *)Mem_Alloc(MEM_TAG_LEVEL, capacity), 0,
+	                 capacity};
+	if (!w.data)
+		return;
+	LevelWriter_Put(&w, LEVEL_MAGIC, 4);
+	LevelWriter_PutU16(&w, LEVEL_FORMAT_VERSION);
+	LevelWriter_PutU16(&w, LEVEL_SECTION_COUNT);
+	LevelWriter_PutU32(&w, 0); // file size, patched below
+	LevelWriter_PutU32(&w, 0); // CRC, patched below
+	int table = w.size;
+	unsigned int ids[LEVEL_SECTION_COUNT] = {
+	    LEVEL_SECTION_INFO, LEVEL_SECTION_DLGS, LEVEL_SECTION_TILE,
+	    LEVEL_SECTION_BGTL};
+	for (int i = 0; i < LEVEL_SECTION_COUNT * 3; i++)
+		LevelWriter_PutU32(&w, 0);
+	for (int i = 0; i < LEVEL_SECTION_COUNT; i++)
 	{
-		qsort(levelFiles, levelCount, sizeof(levelFiles[0]), CompareFilenames);
+		while (w.size % 4 != 0)
+			LevelWriter_PutU8(&w, 0);
+		int start = w.size;
+		if (ids[i] == LEVEL_SECTION_INFO)
+		{
+			LevelWriter_PutU32(&w, lvl->width);
+			LevelWriter_PutU32(&w, lvl->height);
+			LevelWriter_PutF32(&w, lvl->playerSpawn.x);
+			LevelWriter_PutF32(&w, lvl->playerSpawn.y);
+			LevelWriter_PutF32(&w, lvl->goalPos.x);
+			LevelWriter_PutF32(&w, lvl->goalPos.y);
+			LevelWriter_PutU8(&w, lvl->hasGoal);
+			LevelWriter_PutU8(&w, lvl->hasVisualNovel);
+			LevelWriter_PutString(&w, lvl->musicFile, 256, false);
+		}
+		else if (ids[i] == LEVEL_SECTION_DLGS)
+		{
+			int count = lvl->dialogueCount;
+			if (count < 0)
+				count = 0;
+			if (count > 20)
+				count = 20;
+			LevelWriter_PutU8(&w, count);
+			for (int d = 0; d < count; d++)
+			{
+				const VNDialogue *dlg = &lvl->dialogues[d];
+				LevelWriter_PutString(&w, dlg->characterName, 32, false);
+				LevelWriter_PutString(&w, dlg->text, 256, true);
+				LevelWriter_PutString(&w, dlg->characterSprite, 64, false);
+				LevelWriter_PutU8(&w, dlg->bgColor);
+			}
+		}
+		else if (ids[i] == LEVEL_SECTION_TILE)
+		{
+			Level_PutLayer(&w, lvl->tiles, lvl->width, lvl->height);
+		}
+		else
+		{
+			Level_PutLayer(&w, lvl->backgroundTiles, lvl->width, lvl->height);
+		}
+		LevelWriter_SetU32(&w, table + i * LEVEL_SECTION_ENTRY_SIZE, ids[i]);
+		LevelWriter_SetU32(&w, table + i * LEVEL_SECTION_ENTRY_SIZE + 4, start);
+		LevelWriter_SetU32(&w, table + i * LEVEL_SECTION_ENTRY_SIZE + 8,
+		                   w.size - start);
 	}
-	
+	LevelWriter_SetU32(&w, 8, w.size);
+	LevelWriter_SetU32(&w, 12, ComputeCRC32(w.data + LEVEL_HEADER_SIZE,
+	                                        w.size - LEVEL_HEADER_SIZE));
+	// Never rewritten in place: the file may be mapped by a loaded level,
+	// and a crash halfway would leave neither the old nor the new one.
+	if (Writer_WriteFile(filepath, w.data, w.size))
+		Pack_MarkLoose(filepath);
+	Mem_Free(w.data);
+}
+#ifndef CIRNO_HEADLESS
+void Level_Load(Level *lvl, int index)
+{
+	const LevelManifestEntry *entry = Manifest_GetEntry(index);
 	// Load the level if index is valid
-	if (index >= 0 && index < levelCount)
+	if (entry)
 	{
-		Level_LoadFromFile(lvl, levelFiles[index]);
+		Level_LoadFromFile(lvl, entry->path);
 		return;
 	}
 	
 	// If no level file exists, create an empty level
 	Level_Create(lvl, 30, 20);
 }
+#endif
+// Decodes only the fixed fields; no tile grids or dialogue lines.
+bool Level_ReadHeader(const char *filepath, Level *header)
+{
+	MappedFile map;
+	unsigned char *data;
+	int size = 0;
+	bool canMap;
+	if (!Level_OpenData(filepath, &map, &data, &size, &canMap))
+		return false;
+	bool ok = Level_Decode(header, data, size, false, true);
+	MapFile_Close(&map);
+	return ok;
+}
+#ifndef CIRNO_HEADLESS
+// Comes from the manifest, so looking up the next track costs no I/O.
+bool Level_ReadMusicFile(int index, char *musicFile)
+{
+	const LevelManifestEntry *entry = Manifest_GetEntry(index);
+	musicFile[0] = '\0';
+	if (!entry || !entry->hasHeader)
+		return false;
+	strcpy(musicFile, entry->musicFile);
+	return true;
+}
+#endif
 void Level_Unload(Level *lvl)
 {
-	if (lvl->tiles)
+	Level_FreeLayer(lvl->tiles, lvl->height, lvl->tilesMapped);
+	Level_FreeLayer(lvl->backgroundTiles, lvl->height, lvl->backgroundMapped);
+	lvl->tiles = NULL;
+	lvl->backgroundTiles = NULL;
+	lvl->tilesMapped = false;
+	lvl->backgroundMapped = false;
+	MapFile_Close(&lvl->mapping);
+}
+// Moves mapped layers onto the heap and drops the mapping, so the file can
+// be overwritten while the level stays in use.
+void Level_Detach(Level *lvl)
+{
+	if (!lvl->tilesMapped && !lvl->backgroundMapped)
+		return;
+	int **tiles = Level_AllocLayer(lvl->width, lvl->height);
+	int **background = Level_AllocLayer(lvl->width, lvl->height);
+	if (!tiles || !background)
 	{
-		for (int y = 0; y < lvl->height; y++)
-		{
-			free(lvl->tiles[y]);
-		}
-		free(lvl->tiles);
-		lvl->tiles = NULL;
+		Level_FreeLayer(tiles, lvl->height, false);
+		Level_FreeLayer(background, lvl->height, false);
+		return;
 	}
-	if (lvl->backgroundTiles)
+	for (int y = 0; y < lvl->height; y++)
 	{
-		for (int y = 0; y < lvl->height; y++)
-		{
-			free(lvl->backgroundTiles[y]);
-		}
-		free(lvl->backgroundTiles);
-		lvl->backgroundTiles = NULL;
+		memcpy(tiles[y], lvl->tiles[y], lvl->width * sizeof(int));
+		memcpy(background[y], lvl->backgroundTiles[y],
+		       lvl->width * sizeof(int));
 	}
+	Level_Unload(lvl);
+	lvl->tiles = tiles;
+	lvl->backgroundTiles = background;
 }
+#ifndef CIRNO_HEADLESS
 void Level_Draw(const Level *lvl, const Assets *assets, Camera2D camera)
 {
 	// Better culling calculations with zoom support
@@ -237,6 +709,8 @@ void Level_Draw(const Level *lvl, const Assets *assets, Camera2D camera)
 		startY = 0;
 	if (endY >= lvl->height)
 		endY = lvl->height - 1;
+	int drawn = 0;
+	RenderQueue_SetLayer(RENDER_LAYER_BACKGROUND);
 	for (int y = startY; y <= endY; y++)
 	{
 		for (int x = startX; x <= endX; x++)
@@ -248,12 +722,16 @@ void Level_Draw(const Level *lvl, const Assets *assets, Camera2D camera)
 				float posX = (float)(x * TILE_SIZE);
 				float posY = (float)(y * TILE_SIZE);
 				Rectangle dst = {posX, posY, (float)TILE_SIZE + 0.5f, (float)TILE_SIZE + 0.5f};
-				DrawRectangleRec(dst, (Color){100, 100, 150, 100});
-				DrawText(TextFormat("%d", bgTile), x * TILE_SIZE + 5,
-				         y * TILE_SIZE + 5, 12, (Color){255, 255, 255, 150});
+				Rectangle src = Atlas_GetBackgroundTileSource(bgTile);
+				if (src.width > 0)
+				{
+					RenderQueue_Quad(assets->tileset, src, dst, WHITE);
+					drawn++;
+				}
 			}
 		}
 	}
+	RenderQueue_SetLayer(RENDER_LAYER_TILES);
 	for (int y = startY; y <= endY; y++)
 	{
 		for (int x = startX; x <= endX; x++)
@@ -265,67 +743,20 @@ void Level_Draw(const Level *lvl, const Assets *assets, Camera2D camera)
 				float posX = (float)(x * TILE_SIZE);
 				float posY = (float)(y * TILE_SIZE);
 				Rectangle dst = {posX, posY, (float)TILE_SIZE + 0.5f, (float)TILE_SIZE + 0.5f};
-				if (tile == TILE_SPAWNER_CIRCLE)
-				{
-					DrawRectangleRec(dst, (Color){50, 50, 50, 255});
-					DrawCircle(x * TILE_SIZE + 25, y * TILE_SIZE + 25, 18, RED);
-					DrawText("C", x * TILE_SIZE + 20, y * TILE_SIZE + 15, 20,
-					         WHITE);
-				}
-				else if (tile == TILE_SPAWNER_SPIRAL)
-				{
-					DrawRectangleRec(dst, (Color){50, 50, 50, 255});
-					DrawCircle(x * TILE_SIZE + 25, y * TILE_SIZE + 25, 18,
-					           PURPLE);
-					DrawText("S", x * TILE_SIZE + 20, y * TILE_SIZE + 15, 20,
-					         WHITE);
-				}
-				else if (tile == TILE_SPAWNER_WAVE)
-				{
-					DrawRectangleRec(dst, (Color){50, 50, 50, 255});
-					DrawCircle(x * TILE_SIZE + 25, y * TILE_SIZE + 25, 18,
-					           BLUE);
-					DrawText("W", x * TILE_SIZE + 19, y * TILE_SIZE + 15, 20,
-					         WHITE);
-				}
-				else if (tile == TILE_SPAWNER_BURST)
-				{
-					DrawRectangleRec(dst, (Color){50, 50, 50, 255});
-					DrawCircle(x * TILE_SIZE + 25, y * TILE_SIZE + 25, 18,
-					           ORANGE);
-					DrawText("B", x * TILE_SIZE + 20, y * TILE_SIZE + 15, 20,
-					         WHITE);
-				}
-				else if (tile == TILE_CHECKPOINT)
-				{
-					DrawRectangleRec(dst, SKYBLUE);
-					DrawText("CP", x * TILE_SIZE + 12, y * TILE_SIZE + 18, 18,
-					         WHITE);
-				}
-				else if (tile == TILE_DAMAGE)
-				{
-					DrawRectangleRec(dst, ORANGE);
-				}
-				else if (tile == TILE_SPIKE)
-				{
-					DrawRectangleRec(dst, RED);
-					DrawTriangle(
-					    (Vector2){x * TILE_SIZE, y * TILE_SIZE + TILE_SIZE},
-					    (Vector2){x * TILE_SIZE + TILE_SIZE / 2, y * TILE_SIZE},
-					    (Vector2){x * TILE_SIZE + TILE_SIZE,
-					              y * TILE_SIZE + TILE_SIZE},
-					    DARKGRAY);
-				}
-				else
+				// Special tiles are baked into the atlas alongside the
+				// tileset, so the whole layer is one texture.
+				Rectangle src = Assets_GetTileSource(tile);
+				if (src.width > 0)
 				{
-					Rectangle src = Assets_GetTileSource(tile);
-					DrawTexturePro(assets->tileset, src, dst, (Vector2){0, 0},
-					               0, WHITE);
+					RenderQueue_Quad(assets->tileset, src, dst, WHITE);
+					drawn++;
 				}
 			}
 		}
 	}
+	Counters_Gauge(COUNTER_TILES_DRAWN, drawn);
 }
+#endif
 bool Level_IsSolid(const Level *lvl, int tx, int ty)
 {
 	if (tx < 0 || ty < 0 || tx >= lvl->width || ty >= lvl->height)
@@ -2,6 +2,7 @@
 #define LEVEL_H
 #include "assets.h"
 #include "config.h"
+#include "mapfile.h"
 #include "raylib.h"
 typedef struct
 {
@@ -22,12 +23,20 @@ typedef struct
 	bool hasVisualNovel;
 	VNDialogue dialogues[20];
 	int dialogueCount;
+	// Layers read in place from the level file (see Level_LoadFromFile)
+	MappedFile mapping;
+	bool tilesMapped;
+	bool backgroundMapped;
 } Level;
 void Level_Load(Level *lvl, int index);
 void Level_LoadFromFile(Level *lvl, const char *filepath);
+bool Level_TryLoadFromFile(Level *lvl, const char *filepath);
+bool Level_ReadHeader(const char *filepath, Level *header);
+bool Level_ReadMusicFile(int index, char *musicFile);
 void Level_SaveToFile(const Level *lvl, const char *filepath);
 void Level_Create(Level *lvl, int width, int height);
 void Level_Unload(Level *lvl);
+void Level_Detach(Level *lvl);
 void Level_Draw(const Level *lvl, const Assets *assets, Camera2D camera);
 bool Level_IsSolid(const Level *lvl, int tx, int ty);
 int Level_GetTile(const Level *lvl, int tx, int ty);
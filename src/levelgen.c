@@ -0,0 +1,212 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "levelgen.h"
+#include "memtrack.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Layout, from the bottom up: a dirt floor under a grass floor that runs
+// the full width, so the goal at the far end is always reachable on foot;
+// platform rows every four tiles above it; stone walls and ceiling around
+// everything. Checkpoints are set into the floor and spawners only go in
+// the air above the floor corridor, so neither can block the walk.
+#define LEVELGEN_ROW_SPACING 4
+#define LEVELGEN_CLUSTER_RADIUS 8
+#define LEVELGEN_BACKGROUND_VARIANTS 4
+
+typedef struct
+{
+	const char *name;
+	LevelGenOptions options;
+} LevelGenProfile;
+
+// max-spawners goes past MAX_SPAWNERS to exercise the cap and clusters them
+// at the spawn, since bullets fired off screen despawn at once. huge goes
+// past the MAX_WORLD_* limits (it loads only in a build that raises them).
+static const LevelGenProfile profiles[LEVELGEN_PROFILE_COUNT] = {
+    {"default", {1, 64, 32, 0.4f, 8, {1, 1, 1, 1}, 2, false}},
+    {"max-spawners",
+     {2, MAX_WORLD_WIDTH, MAX_WORLD_HEIGHT, 0.3f, MAX_SPAWNERS * 2,
+      {1, 1, 1, 1}, 4, true}},
+    {"max-bullets",
+     {3, 64, 32, 0.2f, MAX_SPAWNERS, {3, 2, 1, 3}, 0, true}},
+    {"dense",
+     {4, MAX_WORLD_WIDTH, MAX_WORLD_HEIGHT, 0.9f, 16, {1, 1, 1, 1}, 8,
+      false}},
+    {"huge",
+     {5, MAX_WORLD_WIDTH * 4, MAX_WORLD_HEIGHT * 4, 0.4f, MAX_SPAWNERS,
+      {1, 1, 1, 1}, 16, false}},
+};
+
+// xorshift32, so a seed means the same level with any C library.
+static unsigned int LevelGen_Next(unsigned int *state)
+{
+	unsigned int x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+static int LevelGen_Range(unsigned int *state, int min, int max)
+{
+	return min + (int)(LevelGen_Next(state) % (unsigned int)(max - min + 1));
+}
+static float LevelGen_Chance(unsigned int *state)
+{
+	return (float)(LevelGen_Next(state) >> 8) / 16777216.0f;
+}
+static int **LevelGen_AllocLayer(int width, int height)
+{
+	int **layer = (int **)Mem_Calloc(MEM_TAG_LEVEL, height, sizeof(int *));
+	for (int y = 0; layer && y < height; y++)
+	{
+		layer[y] = (int *)Mem_Calloc(MEM_TAG_LEVEL, width, sizeof(int));
+		if (!layer[y])
+		{
+			for (int j = 0; j < y; j++)
+				Mem_Free(layer[j]);
+			Mem_Free(layer);
+			return NULL;
+		}
+	}
+	return layer;
+}
+static int LevelGen_PickSpawner(unsigned int *state, const int mix[4])
+{
+	static const int tiles[4] = {TILE_SPAWNER_CIRCLE, TILE_SPAWNER_SPIRAL,
+	                             TILE_SPAWNER_WAVE, TILE_SPAWNER_BURST};
+	int total = 0;
+	for (int i = 0; i < 4; i++)
+		total += mix[i] > 0 ? mix[i] : 0;
+	if (total == 0)
+		return tiles[LevelGen_Range(state, 0, 3)];
+	int pick = LevelGen_Range(state, 0, total - 1);
+	for (int i = 0; i < 4; i++)
+	{
+		if (mix[i] <= 0)
+			continue;
+		if (pick < mix[i])
+			return tiles[i];
+		pick -= mix[i];
+	}
+	return tiles[3];
+}
+void LevelGen_DefaultOptions(LevelGenOptions *options)
+{
+	*options = profiles[0].options;
+}
+bool LevelGen_GetProfile(const char *name, LevelGenOptions *options)
+{
+	for (int i = 0; i < LEVELGEN_PROFILE_COUNT; i++)
+	{
+		if (strcmp(profiles[i].name, name) == 0)
+		{
+			*options = profiles[i].options;
+			return true;
+		}
+	}
+	return false;
+}
+const char *LevelGen_GetProfileName(int index)
+{
+	if (index < 0 || index >= LEVELGEN_PROFILE_COUNT)
+		return NULL;
+	return profiles[index].name;
+}
+// Allocates the layers itself rather than through Level_Create, which
+// would clamp the size to MAX_WORLD_*. Level_Unload frees the result.
+bool LevelGen_Generate(Level *lvl, const LevelGenOptions *options)
+{
+	int width = options->width < MIN_WORLD_WIDTH ? MIN_WORLD_WIDTH
+	                                             : options->width;
+	int height = options->height < MIN_WORLD_HEIGHT ? MIN_WORLD_HEIGHT
+	                                                : options->height;
+	memset(lvl, 0, sizeof(*lvl));
+	lvl->width = width;
+	lvl->height = height;
+	lvl->tiles = LevelGen_AllocLayer(width, height);
+	lvl->backgroundTiles = LevelGen_AllocLayer(width, height);
+	if (!lvl->tiles || !lvl->backgroundTiles)
+	{
+		Level_Unload(lvl);
+		return false;
+	}
+	unsigned int state = options->seed ? options->seed : 1;
+	int floor = height - 2;
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			lvl->backgroundTiles[y][x] =
+			    BACKGROUND_TILE_START +
+			    LevelGen_Range(&state, 0, LEVELGEN_BACKGROUND_VARIANTS - 1);
+			if (y == 0 || x == 0 || x == width - 1)
+				lvl->tiles[y][x] = TILE_STONE;
+			else if (y == floor)
+				lvl->tiles[y][x] = TILE_GRASS;
+			else if (y > floor)
+				lvl->tiles[y][x] = TILE_DIRT;
+		}
+	}
+	// Platform rows alternate solid and open stretches of 2-8 tiles.
+	for (int y = floor - LEVELGEN_ROW_SPACING; y >= 3;
+	     y -= LEVELGEN_ROW_SPACING)
+	{
+		int x = 1;
+		while (x < width - 1)
+		{
+			int run = LevelGen_Range(&state, 2, 8);
+			bool solid = LevelGen_Chance(&state) < options->density;
+			for (int i = x; i < x + run && i < width - 1; i++)
+				lvl->tiles[y][i] = solid ? TILE_GRASS : TILE_EMPTY;
+			x += run;
+		}
+	}
+	for (int i = 0; i < options->checkpointCount && i < width - 6; i++)
+	{
+		int x = 2 + (i + 1) * (width - 5) / (options->checkpointCount + 1);
+		lvl->tiles[floor][x] = TILE_CHECKPOINT;
+	}
+	lvl->playerSpawn = (Vector2){2 * TILE_SIZE, (floor - 1) * TILE_SIZE};
+	Level_SetTile(lvl, width - 3, floor - 1, TILE_GOAL);
+	// Spawners take empty cells above the floor corridor; a crowded map
+	// may place fewer than asked.
+	int minX = 1, maxX = width - 2, minY = 1, maxY = floor - 3;
+	if (options->clusterSpawners)
+	{
+		maxX = 2 + LEVELGEN_CLUSTER_RADIUS < maxX ? 2 + LEVELGEN_CLUSTER_RADIUS
+		                                          : maxX;
+		int top = floor - 1 - LEVELGEN_CLUSTER_RADIUS;
+		minY = top > minY ? top : minY;
+	}
+	int placed = 0;
+	for (int attempt = 0;
+	     placed < options->spawnerCount && attempt < options->spawnerCount * 32;
+	     attempt++)
+	{
+		int x = LevelGen_Range(&state, minX, maxX);
+		int y = LevelGen_Range(&state, minY, maxY > minY ? maxY : minY);
+		if (lvl->tiles[y][x] != TILE_EMPTY)
+			continue;
+		lvl->tiles[y][x] = LevelGen_PickSpawner(&state, options->spawnerMix);
+		placed++;
+	}
+	return true;
+}
@@ -0,0 +1,22 @@
+#ifndef LEVELGEN_H
+#define LEVELGEN_H
+#include "level.h"
+// Seeded generator for stress levels. The same options always give the
+// same level, on every platform.
+typedef struct
+{
+	unsigned int seed;
+	int width;
+	int height;
+	float density;       // share of each platform row that is solid, 0-1
+	int spawnerCount;
+	int spawnerMix[4];   // weights for circle, spiral, wave and burst
+	int checkpointCount;
+	bool clusterSpawners; // keep every spawner on screen at the start
+} LevelGenOptions;
+#define LEVELGEN_PROFILE_COUNT 5
+void LevelGen_DefaultOptions(LevelGenOptions *options);
+bool LevelGen_GetProfile(const char *name, LevelGenOptions *options);
+const char *LevelGen_GetProfileName(int index);
+bool LevelGen_Generate(Level *lvl, const LevelGenOptions *options);
+#endif
@@ -0,0 +1,304 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "loader.h"
+#include "memtrack.h"
+#include "trace.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum
+{
+	LOADER_JOB_FREE,
+	LOADER_JOB_QUEUED,
+	LOADER_JOB_RUNNING,
+	LOADER_JOB_DONE
+} LoaderJobState;
+
+typedef enum
+{
+	LOADER_JOB_IMAGE,
+	LOADER_JOB_WAVE,
+	LOADER_JOB_LEVEL
+} LoaderJobType;
+
+typedef struct
+{
+	LoaderJobState state;
+	LoaderJobType type;
+	bool cancelled;
+	unsigned int order;
+	char path[256];
+	Image image;
+	Wave wave;
+	Level *level; // heap allocated, since a Level is large
+} LoaderJob;
+
+static LoaderJob jobs[LOADER_MAX_JOBS];
+static pthread_t workers[LOADER_THREAD_COUNT];
+static int workerCount = 0;
+static pthread_mutex_t jobLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobQueued = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t jobDone = PTHREAD_COND_INITIALIZER;
+static unsigned int nextOrder = 0;
+static bool stopping = false;
+
+static void Loader_FreeResult(LoaderJob *job)
+{
+	if (job->type == LOADER_JOB_IMAGE)
+	{
+		UnloadImage(job->image);
+	}
+	else if (job->type == LOADER_JOB_WAVE)
+	{
+		UnloadWave(job->wave);
+	}
+	else if (job->level)
+	{
+		Level_Unload(job->level);
+		Mem_Free(job->level);
+	}
+	memset(job, 0, sizeof(LoaderJob));
+}
+// Oldest queued job first, so requests finish in the order they were made.
+static LoaderJob *Loader_NextJob(void)
+{
+	LoaderJob *next = NULL;
+	for (int i = 0; i < LOADER_MAX_JOBS; i++)
+	{
+		if (jobs[i].state == LOADER_JOB_QUEUED &&
+		    (!next || jobs[i].order < next->order))
+			next = &jobs[i];
+	}
+	return next;
+}
+static void *Loader_Worker(void *arg)
+{
+	pthread_mutex_lock(&jobLock);
+	while (!stopping)
+	{
+		LoaderJob *job = Loader_NextJob();
+		if (!job)
+		{
+			pthread_cond_wait(&jobQueued, &jobLock);
+			continue;
+		}
+		job->state = LOADER_JOB_RUNNING;
+		LoaderJobType type = job->type;
+		char path[256];
+		memcpy(path, job->path, sizeof(path));
+		pthread_mutex_unlock(&jobLock);
+
+		// The slow part: file read plus PNG/audio/level decode, outside the
+		// lock.
+		Image image = {0};
+		Wave wave = {0};
+		Level *level = NULL;
+		Trace_Begin("Decode");
+		if (type == LOADER_JOB_IMAGE)
+		{
+			image = LoadImage(path);
+		}
+		else if (type == LOADER_JOB_WAVE)
+		{
+			wave = LoadWave(path);
+		}
+		else
+		{
+			level = Mem_Calloc(MEM_TAG_LEVEL, 1, sizeof(Level));
+			if (level)
+				Level_LoadFromFile(level, path);
+		}
+		Trace_End("Decode");
+
+		pthread_mutex_lock(&jobLock);
+		job->image = image;
+		job->wave = wave;
+		job->level = level;
+		job->state = LOADER_JOB_DONE;
+		if (job->cancelled)
+			Loader_FreeResult(job);
+		pthread_cond_broadcast(&jobDone);
+	}
+	pthread_mutex_unlock(&jobLock);
+	return NULL;
+}
+bool Loader_Init(void)
+{
+	stopping = false;
+	for (int i = 0; i < LOADER_THREAD_COUNT; i++)
+	{
+		if (pthread_create(&workers[workerCount], NULL, Loader_Worker, NULL))
+			break;
+		workerCount++;
+	}
+	return workerCount > 0;
+}
+void Loader_Shutdown(void)
+{
+	pthread_mutex_lock(&jobLock);
+	stopping = true;
+	pthread_cond_broadcast(&jobQueued);
+	pthread_mutex_unlock(&jobLock);
+	for (int i = 0; i < workerCount; i++)
+		pthread_join(workers[i], NULL);
+	workerCount = 0;
+	for (int i = 0; i < LOADER_MAX_JOBS; i++)
+	{
+		if (jobs[i].state != LOADER_JOB_FREE)
+			Loader_FreeResult(&jobs[i]);
+	}
+}
+// Returns -1 when the queue is full or there are no workers; the caller
+// then loads synchronously, as it did before the loader existed.
+static int Loader_Queue(LoaderJobType type, const char *path)
+{
+	if (workerCount == 0)
+		return -1;
+	int id = -1;
+	pthread_mutex_lock(&jobLock);
+	for (int i = 0; i < LOADER_MAX_JOBS; i++)
+	{
+		if (jobs[i].state == LOADER_JOB_FREE)
+		{
+			id = i;
+			break;
+		}
+	}
+	if (id >= 0)
+	{
+		LoaderJob *job = &jobs[id];
+		memset(job, 0, sizeof(LoaderJob));
+		job->type = type;
+		job->order = nextOrder++;
+		strncpy(job->path, path, sizeof(job->path) - 1);
+		job->state = LOADER_JOB_QUEUED;
+		pthread_cond_signal(&jobQueued);
+	}
+	pthread_mutex_unlock(&jobLock);
+	return id;
+}
+int Loader_QueueImage(const char *path)
+{
+	return Loader_Queue(LOADER_JOB_IMAGE, path);
+}
+int Loader_QueueWave(const char *path)
+{
+	return Loader_Queue(LOADER_JOB_WAVE, path);
+}
+int Loader_QueueLevel(const char *path)
+{
+	return Loader_Queue(LOADER_JOB_LEVEL, path);
+}
+bool Loader_IsDone(int job)
+{
+	if (job < 0 || job >= LOADER_MAX_JOBS)
+		return false;
+	pthread_mutex_lock(&jobLock);
+	bool done = jobs[job].state == LOADER_JOB_DONE;
+	pthread_mutex_unlock(&jobLock);
+	return done;
+}
+void Loader_Wait(int job)
+{
+	if (job < 0 || job >= LOADER_MAX_JOBS)
+		return;
+	pthread_mutex_lock(&jobLock);
+	while (jobs[job].state == LOADER_JOB_QUEUED ||
+	       jobs[job].state == LOADER_JOB_RUNNING)
+		pthread_cond_wait(&jobDone, &jobLock);
+	pthread_mutex_unlock(&jobLock);
+}
+// Hands the decoded data to the caller, who then owns it, and frees the
+// job slot. Waits if the job has not finished yet.
+Image Loader_TakeImage(int job)
+{
+	Image image = {0};
+	if (job < 0 || job >= LOADER_MAX_JOBS)
+		return image;
+	Loader_Wait(job);
+	pthread_mutex_lock(&jobLock);
+	image = jobs[job].image;
+	memset(&jobs[job], 0, sizeof(LoaderJob));
+	pthread_mutex_unlock(&jobLock);
+	return image;
+}
+Wave Loader_TakeWave(int job)
+{
+	Wave wave = {0};
+	if (job < 0 || job >= LOADER_MAX_JOBS)
+		return wave;
+	Loader_Wait(job);
+	pthread_mutex_lock(&jobLock);
+	wave = jobs[job].wave;
+	memset(&jobs[job], 0, sizeof(LoaderJob));
+	pthread_mutex_unlock(&jobLock);
+	return wave;
+}
+// Moves the decoded level into *level. False only if the job could not
+// allocate one, in which case *level is untouched.
+bool Loader_TakeLevel(int job, Level *level)
+{
+	if (job < 0 || job >= LOADER_MAX_JOBS)
+		return false;
+	Loader_Wait(job);
+	pthread_mutex_lock(&jobLock);
+	Level *loaded = jobs[job].level;
+	memset(&jobs[job], 0, sizeof(LoaderJob));
+	pthread_mutex_unlock(&jobLock);
+	if (!loaded)
+		return false;
+	*level = *loaded;
+	Mem_Free(loaded);
+	return true;
+}
+void Loader_Cancel(int job)
+{
+	if (job < 0 || job >= LOADER_MAX_JOBS)
+		return;
+	pthread_mutex_lock(&jobLock);
+	if (jobs[job].state == LOADER_JOB_QUEUED ||
+	    jobs[job].state == LOADER_JOB_DONE)
+		Loader_FreeResult(&jobs[job]);
+	else if (jobs[job].state == LOADER_JOB_RUNNING)
+		jobs[job].cancelled = true;
+	pthread_mutex_unlock(&jobLock);
+}
+// Lists the files queued or being decoded, separated by spaces, for the
+// hitch log. Returns how many there are.
+int Loader_DescribePending(char *paths, int size)
+{
+	int count = 0;
+	int used = 0;
+	paths[0] = '\0';
+	pthread_mutex_lock(&jobLock);
+	for (int i = 0; i < LOADER_MAX_JOBS; i++)
+	{
+		if (jobs[i].state != LOADER_JOB_QUEUED &&
+		    jobs[i].state != LOADER_JOB_RUNNING)
+			continue;
+		count++;
+		if (used < size)
+			used += snprintf(paths + used, size - used, "%s%s",
+			                 used > 0 ? " " : "", jobs[i].path);
+	}
+	pthread_mutex_unlock(&jobLock);
+	return count;
+}
@@ -0,0 +1,21 @@
+#ifndef LOADER_H
+#define LOADER_H
+#include "config.h"
+#include "level.h"
+#include "raylib.h"
+// Decodes files into CPU-side Images, Waves and Levels on worker threads.
+// Nothing here touches the GPU or the audio device; the caller uploads
+// results on the main thread. A job id stays valid until it is taken or cancelled.
+bool Loader_Init(void);
+void Loader_Shutdown(void);
+int Loader_QueueImage(const char *path);
+int Loader_QueueWave(const char *path);
+int Loader_QueueLevel(const char *path);
+bool Loader_IsDone(int job);
+void Loader_Wait(int job);
+Image Loader_TakeImage(int job);
+Wave Loader_TakeWave(int job);
+bool Loader_TakeLevel(int job, Level *level);
+void Loader_Cancel(int job);
+int Loader_DescribePending(char *paths, int size);
+#endif
@@ -20,6 +20,7 @@
 #include "config.h"
 #include "game.h"
 #include "raylib.h"
+#include "trace.h"
 int main(void)
 {
 	// Think of a better name for the game.
@@ -29,11 +30,15 @@ int main(void)
 	Game_Init();
 	while (!WindowShouldClose())
 	{
+		Trace_Begin("Update");
 		Game_Update();
+		Trace_End("Update");
+		Trace_Begin("Draw");
 		BeginDrawing();
-		ClearBackground((Color){135, 206, 235, 255});
+		ClearBackground(SKY_COLOR);
 		Game_Draw();
 		EndDrawing();
+		Trace_End("Draw");
 	}
 	Game_Cleanup();
 	CloseWindow();
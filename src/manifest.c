@@ -0,0 +1,178 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if defined(__linux__)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include "manifest.h"
+#include "level.h"
+#include "pack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#define MANIFEST_DIR "assets/levels"
+
+static LevelManifestEntry entries[MAX_LEVELS];
+static int entryCount = 0;
+// Every name joined with ';', the format raygui's dropdown wants.
+static char nameList[MAX_LEVELS * 65];
+static unsigned int version = 0;
+static long dirModTime = 0;
+static float pollTimer = 0.0f;
+static int watchFd = -1;
+
+static int Manifest_CompareEntries(const void *a, const void *b)
+{
+	return strcmp(((const LevelManifestEntry *)a)->path,
+	              ((const LevelManifestEntry *)b)->path);
+}
+// Skips duplicates, so a loose file added first shadows its packed copy.
+static void Manifest_AddEntry(const char *path)
+{
+	if (entryCount >= MAX_LEVELS ||
+	    !TextIsEqual(GetFileExtension(path), ".lvl"))
+		return;
+	for (int i = 0; i < entryCount; i++)
+	{
+		if (strcmp(entries[i].path, path) == 0)
+			return;
+	}
+	LevelManifestEntry *entry = &entries[entryCount++];
+	memset(entry, 0, sizeof(LevelManifestEntry));
+	strncpy(entry->path, path, sizeof(entry->path) - 1);
+}
+void Manifest_Refresh(void)
+{
+	FilePathList files = LoadDirectoryFiles(MANIFEST_DIR);
+	entryCount = 0;
+	for (unsigned int i = 0; i < files.count; i++)
+		Manifest_AddEntry(files.paths[i]);
+	UnloadDirectoryFiles(files);
+	for (int i = 0; i < Pack_GetCount(); i++)
+	{
+		const char *name = Pack_GetName(i);
+		if (TextIsEqual(GetDirectoryPath(name), MANIFEST_DIR))
+			Manifest_AddEntry(name);
+	}
+	if (entryCount > 0)
+	{
+		qsort(entries, entryCount, sizeof(LevelManifestEntry),
+		      Manifest_CompareEntries);
+	}
+	nameList[0] = '\0';
+	int used = 0;
+	Level header;
+	for (int i = 0; i < entryCount; i++)
+	{
+		LevelManifestEntry *entry = &entries[i];
+		strncpy(entry->name, GetFileNameWithoutExt(entry->path),
+		        sizeof(entry->name) - 1);
+		int packedSize = 0;
+		if (Pack_Find(entry->path, &packedSize))
+			entry->size = packedSize;
+		else if (FileExists(entry->path))
+			entry->size = (long)GetFileLength(entry->path);
+		entry->modTime = GetFileModTime(entry->path);
+		if (Level_ReadHeader(entry->path, &header))
+		{
+			entry->hasHeader = true;
+			entry->width = header.width;
+			entry->height = header.height;
+			entry->hasVisualNovel = header.hasVisualNovel;
+			strcpy(entry->musicFile, header.musicFile);
+		}
+		used += snprintf(nameList + used, sizeof(nameList) - used, "%s%s",
+		                 i > 0 ? ";" : "", entry->name);
+	}
+	dirModTime = GetFileModTime(MANIFEST_DIR);
+	version++;
+}
+void Manifest_Init(void)
+{
+#if defined(__linux__)
+	watchFd = inotify_init1(IN_NONBLOCK);
+	if (watchFd >= 0 &&
+	    inotify_add_watch(watchFd, MANIFEST_DIR,
+	                      IN_CREATE | IN_DELETE | IN_CLOSE_WRITE |
+	                          IN_MOVED_FROM | IN_MOVED_TO) < 0)
+	{
+		close(watchFd);
+		watchFd = -1;
+	}
+#endif
+	Manifest_Refresh();
+}
+void Manifest_Shutdown(void)
+{
+#if defined(__linux__)
+	if (watchFd >= 0)
+		close(watchFd);
+#endif
+	watchFd = -1;
+}
+// Without a watch, the directory and file times are checked now and then;
+// a directory mtime alone misses files rewritten in place.
+static bool Manifest_Poll(void)
+{
+	if (GetFileModTime(MANIFEST_DIR) != dirModTime)
+		return true;
+	for (int i = 0; i < entryCount; i++)
+	{
+		if (GetFileModTime(entries[i].path) != entries[i].modTime)
+			return true;
+	}
+	return false;
+}
+// Returns true when the manifest was rebuilt this call.
+bool Manifest_Update(float dt)
+{
+	bool changed = false;
+#if defined(__linux__)
+	if (watchFd >= 0)
+	{
+		char events[4096];
+		while (read(watchFd, events, sizeof(events)) > 0)
+			changed = true;
+		if (changed)
+			Manifest_Refresh();
+		return changed;
+	}
+#endif
+	pollTimer += dt;
+	if (pollTimer < MANIFEST_POLL_INTERVAL)
+		return false;
+	pollTimer = 0.0f;
+	changed = Manifest_Poll();
+	if (changed)
+		Manifest_Refresh();
+	return changed;
+}
+int Manifest_GetCount(void) { return entryCount; }
+const LevelManifestEntry *Manifest_GetEntry(int index)
+{
+	if (index < 0 || index >= entryCount)
+		return NULL;
+	return &entries[index];
+}
+const char *Manifest_GetNameList(void) { return nameList; }
+unsigned int Manifest_GetVersion(void) { return version; }
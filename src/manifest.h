@@ -0,0 +1,26 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+#include "config.h"
+// Sorted list of the level files with their header fields, rebuilt only
+// when the levels directory changes.
+typedef struct
+{
+	char path[256];
+	char name[64];
+	long size;
+	long modTime;
+	bool hasHeader;
+	int width;
+	int height;
+	bool hasVisualNovel;
+	char musicFile[256];
+} LevelManifestEntry;
+void Manifest_Init(void);
+void Manifest_Shutdown(void);
+bool Manifest_Update(float dt);
+void Manifest_Refresh(void);
+int Manifest_GetCount(void);
+const LevelManifestEntry *Manifest_GetEntry(int index);
+const char *Manifest_GetNameList(void);
+unsigned int Manifest_GetVersion(void);
+#endif
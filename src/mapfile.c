@@ -0,0 +1,124 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include "mapfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+// Kept out of every other file: windows.h clashes with raylib's names.
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static bool MapFile_Map(MappedFile *map, const char *path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+	                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	DWORD size = GetFileSize(file, NULL);
+	HANDLE mapping = NULL;
+	if (size != INVALID_FILE_SIZE && size > 0)
+		mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(file);
+	if (!mapping)
+		return false;
+	// The view keeps the mapping object alive on its own.
+	void *view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!view)
+		return false;
+	map->data = (unsigned char *)view;
+	map->size = (int)size;
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0 || st.st_size > 0x7FFFFFFF)
+	{
+		close(fd);
+		return false;
+	}
+	void *view = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+	                  MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (view == MAP_FAILED)
+		return false;
+	map->data = (unsigned char *)view;
+	map->size = (int)st.st_size;
+#endif
+	map->mapped = true;
+	return true;
+}
+static bool MapFile_Read(MappedFile *map, const char *path)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f)
+		return false;
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (size <= 0 || size > 0x7FFFFFFF)
+	{
+		fclose(f);
+		return false;
+	}
+	map->data = (unsigned char *)malloc((size_t)size);
+	if (map->data && fread(map->data, 1, (size_t)size, f) != (size_t)size)
+	{
+		free(map->data);
+		map->data = NULL;
+	}
+	fclose(f);
+	map->size = map->data ? (int)size : 0;
+	map->mapped = false;
+	return map->data != NULL;
+}
+bool MapFile_Open(MappedFile *map, const char *path)
+{
+	memset(map, 0, sizeof(MappedFile));
+	return MapFile_Map(map, path) || MapFile_Read(map, path);
+}
+void MapFile_Close(MappedFile *map)
+{
+	if (!map->data)
+		return;
+	if (map->mapped)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(map->data);
+#else
+		munmap(map->data, (size_t)map->size);
+#endif
+	}
+	else
+	{
+		free(map->data);
+	}
+	memset(map, 0, sizeof(MappedFile));
+}
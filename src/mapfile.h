@@ -0,0 +1,15 @@
+#ifndef MAPFILE_H
+#define MAPFILE_H
+#include <stdbool.h>
+// A private, writable view of a whole file. Writes go to copy-on-write
+// pages and never reach the file. Where mapping is not possible the file
+// is read into memory instead, which behaves the same for the caller.
+typedef struct
+{
+	unsigned char *data;
+	int size;
+	bool mapped;
+} MappedFile;
+bool MapFile_Open(MappedFile *map, const char *path);
+void MapFile_Close(MappedFile *map);
+#endif
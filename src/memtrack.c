@@ -0,0 +1,342 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "memtrack.h"
+#include "config.h"
+#include "writer.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Heap blocks carry a small header with their size and tag, so Mem_Free
+// needs neither. GPU and audio objects are looked up in a registry keyed
+// by texture id or audio buffer, since raylib owns their memory.
+typedef union
+{
+	struct
+	{
+		size_t size;
+		int tag;
+	} info;
+	double align[2];
+} MemHeader;
+
+typedef struct
+{
+	bool used;
+	MemKind kind;
+	MemTag tag;
+	const void *key;
+	size_t bytes;
+} MemResource;
+
+static const char *tagNames[MEM_TAG_COUNT] = {
+    "Level", "Assets", "Bullets", "VN", "Editor", "Saves", "Other"};
+static const char *kindNames[MEM_KIND_COUNT] = {"Heap", "Static", "GPU",
+                                                "Audio"};
+
+static MemCounter counters[MEM_TAG_COUNT][MEM_KIND_COUNT];
+static size_t totalCurrent = 0;
+static size_t totalPeak = 0;
+static MemResource resources[MEM_MAX_RESOURCES];
+static bool visible = false;
+static pthread_mutex_t memLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Callers hold memLock.
+static void Mem_Add(MemTag tag, MemKind kind, size_t bytes)
+{
+	MemCounter *c = &counters[tag][kind];
+	c->current += bytes;
+	c->count++;
+	if (c->current > c->peak)
+		c->peak = c->current;
+	totalCurrent += bytes;
+	if (totalCurrent > totalPeak)
+		totalPeak = totalCurrent;
+}
+static void Mem_Remove(MemTag tag, MemKind kind, size_t bytes)
+{
+	MemCounter *c = &counters[tag][kind];
+	c->current -= bytes < c->current ? bytes : c->current;
+	c->count--;
+	totalCurrent -= bytes < totalCurrent ? bytes : totalCurrent;
+}
+void *Mem_Alloc(MemTag tag, size_t size)
+{
+	MemHeader *header = (MemHeader *)malloc(sizeof(MemHeader) + size);
+	if (!header)
+		return NULL;
+	header->info.size = size;
+	header->info.tag = tag;
+	pthread_mutex_lock(&memLock);
+	Mem_Add(tag, MEM_KIND_HEAP, size);
+	pthread_mutex_unlock(&memLock);
+	return header + 1;
+}
+void *Mem_Calloc(MemTag tag, size_t count, size_t size)
+{
+	if (size != 0 && count > ((size_t)-1 - sizeof(MemHeader)) / size)
+		return NULL;
+	MemHeader *header =
+	    (MemHeader *)calloc(1, sizeof(MemHeader) + count * size);
+	if (!header)
+		return NULL;
+	header->info.size = count * size;
+	header->info.tag = tag;
+	pthread_mutex_lock(&memLock);
+	Mem_Add(tag, MEM_KIND_HEAP, count * size);
+	pthread_mutex_unlock(&memLock);
+	return header + 1;
+}
+// Keeps the block's original tag; tag only applies when ptr is NULL.
+void *Mem_Realloc(MemTag tag, void *ptr, size_t size)
+{
+	if (!ptr)
+		return Mem_Alloc(tag, size);
+	MemHeader *old = (MemHeader *)ptr - 1;
+	size_t oldSize = old->info.size;
+	MemHeader *header = (MemHeader *)realloc(old, sizeof(MemHeader) + size);
+	if (!header)
+		return NULL;
+	header->info.size = size;
+	pthread_mutex_lock(&memLock);
+	Mem_Remove((MemTag)header->info.tag, MEM_KIND_HEAP, oldSize);
+	Mem_Add((MemTag)header->info.tag, MEM_KIND_HEAP, size);
+	pthread_mutex_unlock(&memLock);
+	return header + 1;
+}
+void Mem_Free(void *ptr)
+{
+	if (!ptr)
+		return;
+	MemHeader *header = (MemHeader *)ptr - 1;
+	pthread_mutex_lock(&memLock);
+	Mem_Remove((MemTag)header->info.tag, MEM_KIND_HEAP, header->info.size);
+	pthread_mutex_unlock(&memLock);
+	free(header);
+}
+void Mem_TrackStatic(MemTag tag, size_t size)
+{
+	pthread_mutex_lock(&memLock);
+	Mem_Add(tag, MEM_KIND_STATIC, size);
+	pthread_mutex_unlock(&memLock);
+}
+// For the exit dump, so it lists only what was never freed. Peaks stay.
+void Mem_UntrackStatics(void)
+{
+	pthread_mutex_lock(&memLock);
+	for (int t = 0; t < MEM_TAG_COUNT; t++)
+	{
+		MemCounter *c = &counters[t][MEM_KIND_STATIC];
+		Mem_Remove((MemTag)t, MEM_KIND_STATIC, c->current);
+		c->count = 0;
+	}
+	pthread_mutex_unlock(&memLock);
+}
+#ifndef CIRNO_HEADLESS
+static void Mem_Register(MemTag tag, MemKind kind, const void *key,
+                         size_t bytes)
+{
+	if (!key)
+		return;
+	pthread_mutex_lock(&memLock);
+	for (int i = 0; i < MEM_MAX_RESOURCES; i++)
+	{
+		if (!resources[i].used)
+		{
+			resources[i] = (MemResource){true, kind, tag, key, bytes};
+			Mem_Add(tag, kind, bytes);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&memLock);
+}
+static void Mem_Unregister(MemKind kind, const void *key)
+{
+	pthread_mutex_lock(&memLock);
+	for (int i = 0; i < MEM_MAX_RESOURCES; i++)
+	{
+		MemResource *r = &resources[i];
+		if (r->used && r->kind == kind && r->key == key)
+		{
+			Mem_Remove(r->tag, r->kind, r->bytes);
+			r->used = false;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&memLock);
+}
+// Every mip level, at the texture's own pixel format.
+void Mem_TrackTexture(MemTag tag, const Texture2D *texture)
+{
+	size_t bytes = 0;
+	int width = texture->width;
+	int height = texture->height;
+	for (int i = 0; i < (texture->mipmaps > 0 ? texture->mipmaps : 1); i++)
+	{
+		bytes += (size_t)GetPixelDataSize(width, height, texture->format);
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	Mem_Register(tag, MEM_KIND_GPU, (const void *)(size_t)texture->id, bytes);
+}
+void Mem_UntrackTexture(const Texture2D *texture)
+{
+	Mem_Unregister(MEM_KIND_GPU, (const void *)(size_t)texture->id);
+}
+// raylib converts sounds to the device format, which the stream reports.
+void Mem_TrackSound(MemTag tag, const Sound *sound)
+{
+	size_t bytes = (size_t)sound->frameCount * sound->stream.channels *
+	               sound->stream.sampleSize / 8;
+	Mem_Register(tag, MEM_KIND_AUDIO, sound->stream.buffer, bytes);
+}
+void Mem_UntrackSound(const Sound *sound)
+{
+	Mem_Unregister(MEM_KIND_AUDIO, sound->stream.buffer);
+}
+// A stream holds two sub-buffers of about 1/30 s each; the decoder's own
+// state is not counted.
+void Mem_TrackMusic(MemTag tag, const Music *music)
+{
+	size_t bytes = 2 * (size_t)(music->stream.sampleRate / 30) *
+	               music->stream.channels * music->stream.sampleSize / 8;
+	Mem_Register(tag, MEM_KIND_AUDIO, music->stream.buffer, bytes);
+}
+void Mem_UntrackMusic(const Music *music)
+{
+	Mem_Unregister(MEM_KIND_AUDIO, music->stream.buffer);
+}
+#endif
+MemCounter Mem_GetCounter(MemTag tag, MemKind kind)
+{
+	pthread_mutex_lock(&memLock);
+	MemCounter counter = counters[tag][kind];
+	pthread_mutex_unlock(&memLock);
+	return counter;
+}
+const char *Mem_GetTagName(MemTag tag)
+{
+	return tag >= 0 && tag < MEM_TAG_COUNT ? tagNames[tag] : "?";
+}
+// Peaks restart from the current values, e.g. so a level's peak does not
+// include the one before it.
+void Mem_ResetPeaks(void)
+{
+	pthread_mutex_lock(&memLock);
+	for (int t = 0; t < MEM_TAG_COUNT; t++)
+		for (int k = 0; k < MEM_KIND_COUNT; k++)
+			counters[t][k].peak = counters[t][k].current;
+	totalPeak = totalCurrent;
+	pthread_mutex_unlock(&memLock);
+}
+void Mem_Toggle(void) { visible = !visible; }
+#ifndef CIRNO_HEADLESS
+static size_t Mem_TagPeak(MemTag tag)
+{
+	size_t peak = 0;
+	for (int k = 0; k < MEM_KIND_COUNT; k++)
+		peak += counters[tag][k].peak;
+	return peak;
+}
+// Drawn in HUD coordinates, top left, sizes in KiB.
+void Mem_Draw(void)
+{
+	if (!visible)
+		return;
+	const int x = 10;
+	const int y = 10;
+	const int column = 62;
+	DrawRectangle(x - 5, y - 5, 70 + column * (MEM_KIND_COUNT + 1) + 10,
+	              (MEM_TAG_COUNT + 2) * 14 + 10, (Color){0, 0, 0, 200});
+	DrawText("KiB", x, y, 12, GRAY);
+	for (int k = 0; k < MEM_KIND_COUNT; k++)
+		DrawText(kindNames[k], x + 70 + k * column, y, 12, GRAY);
+	DrawText("Peak", x + 70 + MEM_KIND_COUNT * column, y, 12, GRAY);
+	pthread_mutex_lock(&memLock);
+	for (int t = 0; t < MEM_TAG_COUNT; t++)
+	{
+		int rowY = y + (t + 1) * 14;
+		DrawText(tagNames[t], x, rowY, 12, LIGHTGRAY);
+		for (int k = 0; k < MEM_KIND_COUNT; k++)
+			DrawText(TextFormat("%8.1f", counters[t][k].current / 1024.0),
+			         x + 70 + k * column, rowY, 12, WHITE);
+		DrawText(TextFormat("%8.1f", Mem_TagPeak((MemTag)t) / 1024.0),
+		         x + 70 + MEM_KIND_COUNT * column, rowY, 12, YELLOW);
+	}
+	DrawText(TextFormat("Total %.1f KiB, peak %.1f KiB", totalCurrent / 1024.0,
+	                    totalPeak / 1024.0),
+	         x, y + (MEM_TAG_COUNT + 1) * 14, 12, WHITE);
+	pthread_mutex_unlock(&memLock);
+}
+#endif
+typedef struct
+{
+	char text[16384];
+	int length;
+} MemText;
+
+static void Mem_Print(MemText *out, const char *format, ...)
+{
+	int room = (int)sizeof(out->text) - out->length;
+	if (room <= 1)
+		return;
+	va_list args;
+	va_start(args, format);
+	int written = vsnprintf(out->text + out->length, room, format, args);
+	va_end(args);
+	if (written > 0)
+		out->length += written < room ? written : room - 1;
+}
+// Plain text table in bytes, then every registered GPU and audio object,
+// which is where a leaked texture shows up.
+void Mem_Dump(const char *path)
+{
+	static MemText out;
+	out.length = 0;
+	pthread_mutex_lock(&memLock);
+	Mem_Print(&out, "%-8s", "bytes");
+	for (int k = 0; k < MEM_KIND_COUNT; k++)
+		Mem_Print(&out, " %12s %12s", kindNames[k], "peak");
+	Mem_Print(&out, "\n");
+	for (int t = 0; t < MEM_TAG_COUNT; t++)
+	{
+		Mem_Print(&out, "%-8s", tagNames[t]);
+		for (int k = 0; k < MEM_KIND_COUNT; k++)
+			Mem_Print(&out, " %12lu %12lu",
+			          (unsigned long)counters[t][k].current,
+			          (unsigned long)counters[t][k].peak);
+		Mem_Print(&out, "\n");
+	}
+	Mem_Print(&out, "total %lu, peak %lu\n\n", (unsigned long)totalCurrent,
+	          (unsigned long)totalPeak);
+	for (int i = 0; i < MEM_MAX_RESOURCES; i++)
+	{
+		const MemResource *r = &resources[i];
+		if (r->used)
+			Mem_Print(&out, "%-8s %-6s %12lu\n", tagNames[r->tag],
+			          kindNames[r->kind], (unsigned long)r->bytes);
+	}
+	unsigned long current = (unsigned long)totalCurrent;
+	unsigned long peak = (unsigned long)totalPeak;
+	pthread_mutex_unlock(&memLock);
+	Writer_Submit(path, out.text, out.length);
+	TraceLog(LOG_INFO, "MEM: %lu bytes in use, peak %lu, written to %s",
+	         current, peak, path);
+}
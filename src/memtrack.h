@@ -0,0 +1,56 @@
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+#include <stdbool.h>
+#include <stddef.h>
+// Current and peak bytes per subsystem. Heap blocks count when they go
+// through Mem_*, static arrays when registered once at startup, and GPU
+// textures and audio buffers while they are registered. The F5 overlay
+// shows the table and F6 writes it to MEM_DUMP_FILE. Safe to call from any
+// thread. Kept free of raylib.h so the windows.h modules can use it too.
+typedef enum
+{
+	MEM_TAG_LEVEL,
+	MEM_TAG_ASSETS,
+	MEM_TAG_BULLETS,
+	MEM_TAG_VN,
+	MEM_TAG_EDITOR,
+	MEM_TAG_SAVES,
+	MEM_TAG_OTHER,
+	MEM_TAG_COUNT
+} MemTag;
+typedef enum
+{
+	MEM_KIND_HEAP,
+	MEM_KIND_STATIC,
+	MEM_KIND_GPU,
+	MEM_KIND_AUDIO,
+	MEM_KIND_COUNT
+} MemKind;
+typedef struct
+{
+	size_t current;
+	size_t peak;
+	int count;
+} MemCounter;
+struct Texture;
+struct Sound;
+struct Music;
+void *Mem_Alloc(MemTag tag, size_t size);
+void *Mem_Calloc(MemTag tag, size_t count, size_t size);
+void *Mem_Realloc(MemTag tag, void *ptr, size_t size);
+void Mem_Free(void *ptr);
+void Mem_TrackStatic(MemTag tag, size_t size);
+void Mem_UntrackStatics(void);
+void Mem_TrackTexture(MemTag tag, const struct Texture *texture);
+void Mem_UntrackTexture(const struct Texture *texture);
+void Mem_TrackSound(MemTag tag, const struct Sound *sound);
+void Mem_UntrackSound(const struct Sound *sound);
+void Mem_TrackMusic(MemTag tag, const struct Music *music);
+void Mem_UntrackMusic(const struct Music *music);
+MemCounter Mem_GetCounter(MemTag tag, MemKind kind);
+const char *Mem_GetTagName(MemTag tag);
+void Mem_ResetPeaks(void);
+void Mem_Toggle(void);
+void Mem_Draw(void);
+void Mem_Dump(const char *path);
+#endif
@@ -19,8 +19,13 @@
 #include "menu.h"
 #include "achievement.h"
 #include "game.h"
+#include "memtrack.h"
 #include "raylib.h"
+#include "serial.h"
+#include "writer.h"
+#include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 // Everything in the menu is implemented here.
@@ -42,7 +47,8 @@ static const char *mainMenuItems[] = {"New Game",     "Load Game",
                                       "Settings",     "Quit"};
 
 static const char *settingsItems[] = {
-    "Resolution: ", "Fullscreen: ", "Sound: ", "Key Bindings", "Back"};
+    "Resolution: ",  "Fullscreen: ", "Sound: ", "Render Scale: ",
+    "Dynamic Res: ", "Key Bindings", "Back"};
 
 static const char *keybindingItems[] = {
     "Move Left: ", "Move Right: ",      "Jump: ",
@@ -53,6 +59,9 @@ static const char *keybindingItems[] = {
 static const char *resolutionNames[] = {"800x600", "1024x768", "1280x720",
                                         "1920x1080"};
 
+static const float renderScales[] = {1.0f, 0.75f, 0.5f};
+#define RENDER_SCALE_OPTIONS 3
+
 void Menu_SetDefaultKeyBindings(void)
 {
 	settings.keys.moveLeft = KEY_A;
@@ -161,35 +170,142 @@ void Menu_Init(void)
 	settings.soundEnabled = true;
 	settings.masterVolume = 0.5f;
 	settings.resolution = RES_800x600;
+	settings.renderScale = 1.0f;
+	settings.dynamicResolution = false;
 	Menu_SetDefaultKeyBindings();
 	Menu_LoadSettings();
 }
 Settings *Menu_GetSettings(void) { return &settings; }
+// settings.cfg field ids; never reuse a retired one.
+#define SETTINGS_MAGIC "CCFG"
+// Before the tagged format settings.cfg held the raw struct. Builds from
+// before renderScale wrote only the part ahead of it, which must not move.
+#define SETTINGS_LEGACY_SIZE 68
+typedef char SettingsLegacyCheck
+    [offsetof(Settings, renderScale) == SETTINGS_LEGACY_SIZE ? 1 : -1];
+#define SETTINGS_FORMAT_VERSION 1
+#define SETTINGS_FIELD_FULLSCREEN 1
+#define SETTINGS_FIELD_SOUND 2
+#define SETTINGS_FIELD_VOLUME 3
+#define SETTINGS_FIELD_RESOLUTION 4
+#define SETTINGS_FIELD_KEYS 5
+#define SETTINGS_FIELD_RENDER_SCALE 6
+#define SETTINGS_FIELD_DYNAMIC_RESOLUTION 7
+// Inside SETTINGS_FIELD_KEYS each binding's id is its index here plus one,
+// so append new bindings at the end.
+static const size_t keyFieldOffsets[] = {
+    offsetof(KeyBindings, moveLeft),   offsetof(KeyBindings, moveRight),
+    offsetof(KeyBindings, jump),       offsetof(KeyBindings, dash),
+    offsetof(KeyBindings, wallCling),  offsetof(KeyBindings, floatKey),
+    offsetof(KeyBindings, slowDown),   offsetof(KeyBindings, heal),
+    offsetof(KeyBindings, pause),      offsetof(KeyBindings, spellcard),
+    offsetof(KeyBindings, menuUp),     offsetof(KeyBindings, menuDown),
+    offsetof(KeyBindings, menuSelect), offsetof(KeyBindings, menuBack)};
+#define KEY_FIELD_COUNT (int)(sizeof(keyFieldOffsets) / sizeof(size_t))
+
+static int *Menu_KeyField(KeyBindings *keys, int index)
+{
+	return (int *)((char *)keys + keyFieldOffsets[index]);
+}
+
 void Menu_SaveSettings(void)
 {
-	FILE *f = fopen("settings.cfg", "wb");
-	if (f)
+	SerialWriter w;
+	SerialWriter_Begin(&w, SETTINGS_MAGIC, SETTINGS_FORMAT_VERSION);
+	SerialWriter_PutInt(&w, SETTINGS_FIELD_FULLSCREEN, settings.fullscreen);
+	SerialWriter_PutInt(&w, SETTINGS_FIELD_SOUND, settings.soundEnabled);
+	SerialWriter_PutFloat(&w, SETTINGS_FIELD_VOLUME, settings.masterVolume);
+	SerialWriter_PutInt(&w, SETTINGS_FIELD_RESOLUTION, settings.resolution);
+	int keys = SerialWriter_BeginSection(&w, SETTINGS_FIELD_KEYS);
+	for (int i = 0; i < KEY_FIELD_COUNT; i++)
 	{
-		fwrite(&settings, sizeof(Settings), 1, f);
-		fclose(f);
+		SerialWriter_PutInt(&w, i + 1, *Menu_KeyField(&settings.keys, i));
+	}
+	SerialWriter_EndSection(&w, keys);
+	SerialWriter_PutFloat(&w, SETTINGS_FIELD_RENDER_SCALE,
+	                      settings.renderScale);
+	SerialWriter_PutInt(&w, SETTINGS_FIELD_DYNAMIC_RESOLUTION,
+	                    settings.dynamicResolution);
+	if (!w.failed)
+		Writer_Submit("settings.cfg", w.data, w.size);
+	SerialWriter_Free(&w);
+}
+// Fields the file does not have keep the defaults set by Menu_Init.
+static void Menu_DeserializeSettings(SerialReader *r)
+{
+	SerialField field;
+	while (SerialReader_Next(r, &field))
+	{
+		switch (field.id)
+		{
+		case SETTINGS_FIELD_FULLSCREEN:
+			settings.fullscreen = Serial_GetInt(&field) != 0;
+			break;
+		case SETTINGS_FIELD_SOUND:
+			settings.soundEnabled = Serial_GetInt(&field) != 0;
+			break;
+		case SETTINGS_FIELD_VOLUME:
+			settings.masterVolume = Serial_GetFloat(&field);
+			break;
+		case SETTINGS_FIELD_RESOLUTION:
+		{
+			int resolution = Serial_GetInt(&field);
+			if (resolution >= 0 && resolution < RES_COUNT)
+				settings.resolution = (ResolutionMode)resolution;
+			break;
+		}
+		case SETTINGS_FIELD_KEYS:
+		{
+			SerialReader keys;
+			SerialField key;
+			SerialReader_OpenSection(&keys, &field);
+			while (SerialReader_Next(&keys, &key))
+			{
+				if (key.id >= 1 && key.id <= KEY_FIELD_COUNT)
+					*Menu_KeyField(&settings.keys, key.id - 1) =
+					    Serial_GetInt(&key);
+			}
+			break;
+		}
+		case SETTINGS_FIELD_RENDER_SCALE:
+			settings.renderScale = Serial_GetFloat(&field);
+			break;
+		case SETTINGS_FIELD_DYNAMIC_RESOLUTION:
+			settings.dynamicResolution = Serial_GetInt(&field) != 0;
+			break;
+		default:
+			break;
+		}
 	}
 }
 void Menu_LoadSettings(void)
 {
-	FILE *f = fopen("settings.cfg", "rb");
-	if (f)
+	int size = 0;
+	unsigned char *data = Serial_ReadFile("settings.cfg", &size);
+	if (data)
 	{
-		Settings loadedSettings;
-		size_t result = fread(&loadedSettings, sizeof(Settings), 1, f);
-		fclose(f);
-		if (result == 1)
+		SerialReader r;
+		if (SerialReader_Open(&r, data, size, SETTINGS_MAGIC, NULL))
 		{
-			settings = loadedSettings;
+			Menu_DeserializeSettings(&r);
+		}
+		else if (size == (int)sizeof(Settings) ||
+		         size == SETTINGS_LEGACY_SIZE)
+		{
+			// The raw struct; a short one keeps Menu_Init's defaults for
+			// the fields after it.
+			memcpy(&settings, data, size);
 		}
 		else
 		{
 			Menu_SetDefaultKeyBindings();
 		}
+		Mem_Free(data);
+		if (!(settings.renderScale >= RENDER_SCALE_MIN &&
+		      settings.renderScale <= RENDER_SCALE_MAX))
+		{
+			settings.renderScale = 1.0f;
+		}
 		Menu_ApplyResolution();
 		if (settings.fullscreen && !IsWindowFullscreen())
 		{
@@ -287,9 +403,9 @@ void Menu_Update(void)
 	else if (currentScreen == MENU_SETTINGS)
 	{
 		if (IsKeyPressed(KEY_DOWN))
-			selectedIndex = (selectedIndex + 1) % 5;
+			selectedIndex = (selectedIndex + 1) % 7;
 		if (IsKeyPressed(KEY_UP))
-			selectedIndex = (selectedIndex + 4) % 5;
+			selectedIndex = (selectedIndex + 6) % 7;
 		if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_SPACE))
 		{
 			if (selectedIndex == 0)
@@ -312,11 +428,30 @@ void Menu_Update(void)
 				Menu_SaveSettings();
 			}
 			if (selectedIndex == 3)
+			{
+				int next = 0;
+				for (int i = 0; i < RENDER_SCALE_OPTIONS; i++)
+				{
+					if (settings.renderScale >= renderScales[i] - 0.01f)
+					{
+						next = (i + 1) % RENDER_SCALE_OPTIONS;
+						break;
+					}
+				}
+				settings.renderScale = renderScales[next];
+				Menu_SaveSettings();
+			}
+			if (selectedIndex == 4)
+			{
+				settings.dynamicResolution = !settings.dynamicResolution;
+				Menu_SaveSettings();
+			}
+			if (selectedIndex == 5)
 			{
 				currentScreen = MENU_KEYBINDINGS;
 				selectedIndex = 0;
 			}
-			if (selectedIndex == 4)
+			if (selectedIndex == 6)
 			{
 				currentScreen = MENU_MAIN;
 				selectedIndex = 0;
@@ -402,7 +537,7 @@ void Menu_Draw(void)
 	else if (currentScreen == MENU_SETTINGS)
 	{
 		DrawText("SETTINGS", SCREEN_WIDTH / 2 - 80, 150, 32, SKYBLUE);
-		for (int i = 0; i < 5; i++)
+		for (int i = 0; i < 7; i++)
 		{
 			Color c = (i == selectedIndex) ? YELLOW : WHITE;
 			if (i == 0)
@@ -426,15 +561,38 @@ void Menu_Draw(void)
 				DrawText(settings.soundEnabled ? "ON" : "OFF",
 				         SCREEN_WIDTH / 2 + 80, 220 + i * 40, 24, c);
 			}
+			else if (i == 3)
+			{
+				DrawText(settingsItems[i], SCREEN_WIDTH / 2 - 140, 220 + i * 40,
+				         24, c);
+				DrawText(TextFormat("%d%%", (int)(settings.renderScale * 100 +
+				                                  0.5f)),
+				         SCREEN_WIDTH / 2 + 80, 220 + i * 40, 24, c);
+			}
+			else if (i == 4)
+			{
+				DrawText(settingsItems[i], SCREEN_WIDTH / 2 - 140, 220 + i * 40,
+				         24, c);
+				DrawText(settings.dynamicResolution ? "ON" : "OFF",
+				         SCREEN_WIDTH / 2 + 80, 220 + i * 40, 24, c);
+			}
 			else
 			{
 				DrawText(settingsItems[i], SCREEN_WIDTH / 2 - 140, 220 + i * 40,
 				         24, c);
 			}
 		}
-		DrawText("Press ENTER to toggle/select", SCREEN_WIDTH / 2 - 110, 440,
+		// Only World_Draw goes through the scaled target.
+		if (selectedIndex == 3 || selectedIndex == 4)
+		{
+			const char *hint = "Applies to levels only; menus and the editor "
+			                   "stay sharp";
+			DrawText(hint, (SCREEN_WIDTH - MeasureText(hint, 16)) / 2, 488, 16,
+			         SKYBLUE);
+		}
+		DrawText("Press ENTER to toggle/select", SCREEN_WIDTH / 2 - 110, 510,
 		         18, GRAY);
-		DrawText("Press ESC to go back", SCREEN_WIDTH / 2 - 90, 470, 18, GRAY);
+		DrawText("Press ESC to go back", SCREEN_WIDTH / 2 - 90, 540, 18, GRAY);
 	}
 	else if (currentScreen == MENU_ACHIEVEMENTS)
 	{
@@ -0,0 +1,231 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pack.h"
+#include "mapfile.h"
+#include "memtrack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The whole archive is mapped once. Lookups hash the name into an open
+// addressed slot table, so finding an asset never scans the entry list.
+// Which entries a loose file overrides is worked out once at Pack_Open,
+// so a packed asset is found without touching the file system.
+#define PACK_HEADER_SIZE 24
+#define PACK_ENTRY_SIZE 16
+#define PACK_EMPTY_SLOT 0xFFFFFFFFu
+
+static MappedFile pack = {0};
+static unsigned int entryCount = 0;
+static unsigned int slotCount = 0;
+static const unsigned char *slots = NULL;
+static const unsigned char *entries = NULL;
+static const char *names = NULL;
+static unsigned int namesSize = 0;
+static bool *loose = NULL; // per entry: a loose file wins over the packed copy
+
+static unsigned int Pack_ReadU32(const unsigned char *p)
+{
+	return (unsigned int)p[0] | ((unsigned int)p[1] << 8) |
+	       ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+// FNV-1a; tools/mkpak.c builds the slot table with the same function.
+static unsigned int Pack_Hash(const char *name)
+{
+	unsigned int hash = 2166136261u;
+	for (const char *c = name; *c; c++)
+	{
+		hash ^= (unsigned char)*c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+// Loose paths may be written "./assets/x" or with backslashes on Windows;
+// the pack stores "assets/x".
+static void Pack_NormalizeName(const char *name, char *out, int outSize)
+{
+	while (name[0] == '.' && (name[1] == '/' || name[1] == '\\'))
+		name += 2;
+	int i = 0;
+	for (; name[i] && i < outSize - 1; i++)
+		out[i] = name[i] == '\\' ? '/' : name[i];
+	out[i] = '\0';
+}
+// Index of the entry stored under name, or -1.
+static int Pack_FindEntry(const char *name)
+{
+	if (!pack.data || entryCount == 0)
+		return -1;
+	char key[256];
+	Pack_NormalizeName(name, key, sizeof(key));
+	unsigned int hash = Pack_Hash(key);
+	unsigned int mask = slotCount - 1;
+	for (unsigned int probe = 0; probe < slotCount; probe++)
+	{
+		unsigned int index = Pack_ReadU32(slots + ((hash + probe) & mask) * 4);
+		if (index == PACK_EMPTY_SLOT || index >= entryCount)
+			return -1;
+		const unsigned char *e = entries + index * PACK_ENTRY_SIZE;
+		if (Pack_ReadU32(e) == hash &&
+		    strcmp(names + Pack_ReadU32(e + 4), key) == 0)
+			return (int)index;
+	}
+	return -1;
+}
+#ifndef CIRNO_HEADLESS
+// Hands raylib a heap copy, since it frees what LoadFileData returns. Runs
+// on the loader threads too, which is fine: the pack is read-only.
+static unsigned char *Pack_LoadFileData(const char *fileName, int *dataSize)
+{
+	*dataSize = 0;
+	int size = 0;
+	const unsigned char *packed = Pack_Find(fileName, &size);
+	if (packed)
+	{
+		unsigned char *data = (unsigned char *)malloc(size > 0 ? size : 1);
+		if (data)
+		{
+			memcpy(data, packed, size);
+			*dataSize = size;
+		}
+		return data;
+	}
+	FILE *f = fopen(fileName, "rb");
+	if (!f)
+		return NULL;
+	fseek(f, 0, SEEK_END);
+	long length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	unsigned char *data =
+	    length > 0 ? (unsigned char *)malloc((size_t)length) : NULL;
+	if (data && fread(data, 1, (size_t)length, f) == (size_t)length)
+		*dataSize = (int)length;
+	else if (data)
+	{
+		free(data);
+		data = NULL;
+	}
+	fclose(f);
+	return data;
+}
+#endif
+bool Pack_Open(const char *path)
+{
+	if (!FileExists(path) || !MapFile_Open(&pack, path))
+		return false;
+	const unsigned char *data = pack.data;
+	unsigned int size = (unsigned int)pack.size;
+	bool ok = size >= PACK_HEADER_SIZE && memcmp(data, PACK_MAGIC, 4) == 0 &&
+	          Pack_ReadU32(data + 4) == PACK_VERSION;
+	if (ok)
+	{
+		entryCount = Pack_ReadU32(data + 8);
+		slotCount = Pack_ReadU32(data + 12);
+		unsigned int tocOffset = Pack_ReadU32(data + 16);
+		unsigned int namesOffset = Pack_ReadU32(data + 20);
+		unsigned long long tocEnd =
+		    (unsigned long long)tocOffset + slotCount * 4ull +
+		    entryCount * (unsigned long long)PACK_ENTRY_SIZE;
+		ok = slotCount > entryCount && (slotCount & (slotCount - 1)) == 0 &&
+		     tocEnd <= namesOffset && namesOffset <= size;
+		if (ok)
+		{
+			slots = data + tocOffset;
+			entries = slots + slotCount * 4;
+			names = (const char *)data + namesOffset;
+			namesSize = size - namesOffset;
+		}
+	}
+	// Every entry must point inside the file and at a terminated name.
+	for (unsigned int i = 0; ok && i < entryCount; i++)
+	{
+		const unsigned char *e = entries + i * PACK_ENTRY_SIZE;
+		unsigned int nameOffset = Pack_ReadU32(e + 4);
+		unsigned int dataOffset = Pack_ReadU32(e + 8);
+		unsigned int dataSize = Pack_ReadU32(e + 12);
+		ok = nameOffset < namesSize &&
+		     memchr(names + nameOffset, '\0', namesSize - nameOffset) &&
+		     dataOffset <= size && dataSize <= size - dataOffset;
+	}
+	if (!ok)
+	{
+		TraceLog(LOG_WARNING, "PACK: %s is not a valid pack", path);
+		Pack_Close();
+		return false;
+	}
+	// The only loose probes while the pack is open: one per entry, here.
+	loose = (bool *)Mem_Calloc(MEM_TAG_ASSETS, entryCount + 1, sizeof(bool));
+	int overrides = 0;
+	for (unsigned int i = 0; loose && i < entryCount; i++)
+	{
+		loose[i] = FileExists(Pack_GetName((int)i));
+		overrides += loose[i];
+	}
+#ifndef CIRNO_HEADLESS
+	SetLoadFileDataCallback(Pack_LoadFileData);
+#endif
+	TraceLog(LOG_INFO, "PACK: %s opened, %u entries, %d overridden by loose "
+	         "files", path, entryCount, overrides);
+	return true;
+}
+void Pack_Close(void)
+{
+#ifndef CIRNO_HEADLESS
+	if (pack.data)
+		SetLoadFileDataCallback(NULL);
+#endif
+	MapFile_Close(&pack);
+	Mem_Free(loose);
+	loose = NULL;
+	entryCount = 0;
+	slotCount = 0;
+	slots = NULL;
+	entries = NULL;
+	names = NULL;
+	namesSize = 0;
+}
+const unsigned char *Pack_Find(const char *name, int *size)
+{
+	int index = Pack_FindEntry(name);
+	if (index < 0 || (loose && loose[index]))
+		return NULL;
+	const unsigned char *e = entries + index * PACK_ENTRY_SIZE;
+	if (size)
+		*size = (int)Pack_ReadU32(e + 12);
+	return pack.data + Pack_ReadU32(e + 8);
+}
+bool Pack_Exists(const char *name)
+{
+	return Pack_Find(name, NULL) != NULL || FileExists(name);
+}
+// For files written while the game runs, such as a level saved from the
+// editor, which would otherwise stay hidden behind the packed copy.
+void Pack_MarkLoose(const char *name)
+{
+	int index = Pack_FindEntry(name);
+	if (index >= 0 && loose)
+		loose[index] = true;
+}
+int Pack_GetCount(void) { return (int)entryCount; }
+const char *Pack_GetName(int index)
+{
+	if (index < 0 || index >= (int)entryCount)
+		return NULL;
+	return names + Pack_ReadU32(entries + index * PACK_ENTRY_SIZE + 4);
+}
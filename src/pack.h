@@ -0,0 +1,17 @@
+#ifndef PACK_H
+#define PACK_H
+#include "config.h"
+// Read-only archive of the game's assets (see tools/mkpak.c for the
+// layout). Names are the same relative paths the loose files use, and a
+// loose file present at Pack_Open, or marked later, wins over the packed
+// copy. Pack_Find returns NULL for those, so the caller reads the file.
+#define PACK_MAGIC "CPAK"
+#define PACK_VERSION 1
+bool Pack_Open(const char *path);
+void Pack_Close(void);
+const unsigned char *Pack_Find(const char *name, int *size);
+bool Pack_Exists(const char *name);
+void Pack_MarkLoose(const char *name);
+int Pack_GetCount(void);
+const char *Pack_GetName(int index);
+#endif
@@ -17,6 +17,8 @@
  */
 
 #include "player.h"
+#include "atlas.h"
+#include "renderqueue.h"
 #include "config.h"
 #include <math.h>
 #include <stdio.h>
@@ -48,7 +50,6 @@ void Player_Init(Player *p, Vector2 spawn)
 	p->animFrame = 0;
 	p->animTimer = 0;
 	p->facingRight = true;
-	p->hasSprite = false;
 	p->isSlowingDown = false;
 	p->isDucking = false;
 	p->parryWindowTimer = 0;
@@ -58,13 +59,27 @@ void Player_Init(Player *p, Vector2 spawn)
 	p->spellCard.active = false;
 	p->spellCard.timer = 0;
 	p->spellCard.radius = 50.0f;
-	if (FileExists(ASSET_PLAYER_PATH))
-	{
-		p->spriteSheet = LoadTexture(ASSET_PLAYER_PATH);
-		p->hasSprite = true;
-	}
+	p->hasSprite = Atlas_HasPlayerSprite();
+}
+#ifndef CIRNO_HEADLESS
+PlayerInput Player_ReadInput(const KeyBindings *keys)
+{
+	PlayerInput input = {0};
+	input.left = IsKeyDown(keys->moveLeft) || IsKeyDown(KEY_LEFT);
+	input.right = IsKeyDown(keys->moveRight) || IsKeyDown(KEY_RIGHT);
+	input.up = IsKeyDown(keys->jump) || IsKeyDown(KEY_W) || IsKeyDown(KEY_UP);
+	input.down = IsKeyDown(KEY_DOWN);
+	input.jumpPressed = IsKeyPressed(keys->jump);
+	input.dashPressed = IsKeyPressed(keys->dash);
+	input.floatPressed = IsKeyPressed(keys->floatKey);
+	input.spellcardPressed = IsKeyPressed(keys->spellcard);
+	input.cling = IsKeyDown(keys->wallCling);
+	input.slowDown = IsKeyDown(keys->slowDown);
+	return input;
 }
-void Player_Update(Player *p, float dt, Assets *assets, const KeyBindings *keys)
+#endif
+void Player_Update(Player *p, float dt, Assets *assets,
+                   const PlayerInput *input)
 {
 	if (p->dashCooldown > 0)
 		p->dashCooldown -= dt;
@@ -116,7 +131,7 @@ void Player_Update(Player *p, float dt, Assets *assets, const KeyBindings *keys)
 	{
 		p->wallJumpTime = PLAYER_WALL_JUMP_TIME;
 	}
-	if (IsKeyPressed(keys->floatKey) && !p->onGround && !p->isFloating &&
+	if (input->floatPressed && !p->onGround && !p->isFloating &&
 	    p->floatCooldown <= 0)
 	{
 		p->isFloating = true;
@@ -124,7 +139,7 @@ void Player_Update(Player *p, float dt, Assets *assets, const KeyBindings *keys)
 		p->floatCooldown = PLAYER_FLOAT_COOLDOWN;
 		p->velocity.y = 0;
 	}
-	bool wantsToCling = IsKeyDown(keys->wallCling);
+	bool wantsToCling = input->cling;
 	if (p->onWall && !p->onGround && wantsToCling)
 	{
 		if (!p->isClinging)
@@ -143,32 +158,31 @@ void Player_Update(Player *p, float dt, Assets *assets, const KeyBindings *keys)
 		p->isClinging = false;
 		p->clingTimer = 0;
 	}
-	bool movingLeft = IsKeyDown(keys->moveLeft) || IsKeyDown(KEY_LEFT);
-	bool movingRight = IsKeyDown(keys->moveRight) || IsKeyDown(KEY_RIGHT);
-	bool movingUp =
-	    IsKeyDown(keys->jump) || IsKeyDown(KEY_W) || IsKeyDown(KEY_UP);
-	bool movingDown = IsKeyDown(KEY_DOWN);
+	bool movingLeft = input->left;
+	bool movingRight = input->right;
+	bool movingUp = input->up;
+	bool movingDown = input->down;
 	
 	// Duck mode: sticky behavior - once ducking, stay ducking until key released
-	if (IsKeyDown(KEY_DOWN) && p->onGround)
+	if (movingDown && p->onGround)
 	{
 		p->isDucking = true;
 	}
-	else if (!IsKeyDown(KEY_DOWN))
+	else if (!movingDown)
 	{
 		p->isDucking = false;
 	}
 	// else: maintain current isDucking state if key held but not on ground
 	
 	// Spell card activation
-	if (IsKeyPressed(keys->spellcard) && p->canSpellCard)
+	if (input->spellcardPressed && p->canSpellCard)
 	{
 		p->canSpellCard = false;
 		p->spellCard.active = true;
 		p->spellCard.timer = SPELLCARDTIME;  // 10 second duration
 	}
 	
-	if (IsKeyPressed(keys->dash) && p->dashCooldown <= 0 && p->canDash &&
+	if (input->dashPressed && p->dashCooldown <= 0 && p->canDash &&
 	    !p->isFloating)
 	{
 		p->dashCooldown = PLAYER_DASH_COOLDOWN;
@@ -230,7 +244,7 @@ void Player_Update(Player *p, float dt, Assets *assets, const KeyBindings *keys)
 			p->facingRight = true;
 		}
 	}
-	if (IsKeyDown(keys->slowDown))
+	if (input->slowDown)
 	{
 		p->velocity.x *= PLAYER_SLOWDOWN_MULTIPLIER;
 		p->isSlowingDown = true;
@@ -251,13 +265,12 @@ void Player_Update(Player *p, float dt, Assets *assets, const KeyBindings *keys)
 	{
 		p->isSlowingDown = false;
 	}
-	if (IsKeyPressed(keys->spellcard) && p->canSpellCard)
+	if (input->spellcardPressed && p->canSpellCard)
 	{
 		printf("Spell Card Activated!\n");
 		p->canSpellCard = false;
 	}
-	bool jumpPressed = IsKeyPressed(
-	    keys->jump); //|| IsKeyPressed(KEY_W) || IsKeyPressed(KEY_UP);
+	bool jumpPressed = input->jumpPressed;
 	if (jumpPressed)
 	{
 		p->jumpBufferTime = PLAYER_JUMP_BUFFER_TIME;
@@ -304,8 +317,7 @@ void Player_Update(Player *p, float dt, Assets *assets, const KeyBindings *keys)
 			Assets_PlayJumpSound(assets);
 		}
 	}
-	bool jumpHeld =
-	    IsKeyDown(keys->jump) || IsKeyDown(KEY_W) || IsKeyDown(KEY_UP);
+	bool jumpHeld = input->up;
 	if (!jumpHeld && p->velocity.y < -100 && p->dashTimer <= 0)
 	{
 		p->velocity.y = -100;
@@ -468,28 +480,26 @@ void Player_Heal(Player *p, int amount)
 		p->health = p->maxHealth;
 }
 bool Player_IsAlive(const Player *p) { return p->health > 0; }
+#ifndef CIRNO_HEADLESS
 void Player_Draw(const Player *p)
 {
+	RenderQueue_SetLayer(RENDER_LAYER_PLAYER);
 	if (p->hasSprite)
 	{
-		Rectangle sourceRect = {p->animFrame * PLAYER_SIZE,
-		                        p->animState * PLAYER_SIZE, PLAYER_SIZE,
-		                        PLAYER_SIZE};
+		Rectangle sourceRect = Atlas_GetPlayerFrame(p->animState, p->animFrame);
 		if (!p->facingRight)
 		{
 			sourceRect.width = -PLAYER_SIZE;
 		}
 		Rectangle destRect = {p->position.x, p->position.y, PLAYER_SIZE,
 		                      PLAYER_SIZE};
-		Vector2 origin = {0, 0};
 		Color tint = WHITE;
 		if (p->invulnerabilityTimer > 0 &&
 		    ((int)(p->invulnerabilityTimer * 20) % 2 == 0))
 		{
 			tint = (Color){255, 100, 100, 255};
 		}
-		DrawTexturePro(p->spriteSheet, sourceRect, destRect, origin, 0.0f,
-		               tint);
+		RenderQueue_Quad(Atlas_GetTexture(), sourceRect, destRect, tint);
 	}
 	else
 	{
@@ -535,45 +545,49 @@ void Player_Draw(const Player *p)
 		if (p->dashTimer > 0)
 		{
 			playerColor = YELLOW;
-			DrawRectangle((int)p->position.x - 5, (int)p->position.y - 5,
-			              PLAYER_SIZE + 10, PLAYER_SIZE + 10,
-			              (Color){255, 255, 0, 100});
+			RenderQueue_Rectangle((int)p->position.x - 5,
+			                      (int)p->position.y - 5, PLAYER_SIZE + 10,
+			                      PLAYER_SIZE + 10, (Color){255, 255, 0, 100});
 		}
 		if (p->isFloating)
 		{
 			playerColor = SKYBLUE;
-			DrawRectangle((int)p->position.x - 8, (int)p->position.y - 8,
-			              PLAYER_SIZE + 16, PLAYER_SIZE + 16,
-			              (Color){135, 206, 235, 80});
-			DrawRectangle((int)p->position.x - 4, (int)p->position.y - 4,
-			              PLAYER_SIZE + 8, PLAYER_SIZE + 8,
-			              (Color){135, 206, 235, 120});
+			RenderQueue_Rectangle((int)p->position.x - 8,
+			                      (int)p->position.y - 8, PLAYER_SIZE + 16,
+			                      PLAYER_SIZE + 16, (Color){135, 206, 235, 80});
+			RenderQueue_Rectangle((int)p->position.x - 4,
+			                      (int)p->position.y - 4, PLAYER_SIZE + 8,
+			                      PLAYER_SIZE + 8, (Color){135, 206, 235, 120});
 		}
 		
-		DrawRectangle((int)p->position.x, (int)p->position.y, PLAYER_SIZE,
-		              PLAYER_SIZE, playerColor);		
+		RenderQueue_Rectangle((int)p->position.x, (int)p->position.y,
+		                      PLAYER_SIZE, PLAYER_SIZE, playerColor);
 		// Draw spell card effect
 		if (p->spellCard.active)
 		{
 			Vector2 center = {p->position.x + PLAYER_SIZE / 2, p->position.y + PLAYER_SIZE / 2};
-			DrawCircleV(center, p->spellCard.radius, (Color){100, 150, 255, 100});
-			DrawCircleLines((int)center.x, (int)center.y, (int)p->spellCard.radius, (Color){100, 150, 255, 200});
-			DrawText(TextFormat("%.1f", p->spellCard.timer), (int)center.x - 20, (int)center.y - 10, 20, BLUE);
+			RenderQueue_CircleV(center, p->spellCard.radius,
+			                    (Color){100, 150, 255, 100});
+			RenderQueue_CircleLines((int)center.x, (int)center.y,
+			                        (int)p->spellCard.radius,
+			                        (Color){100, 150, 255, 200});
+			RenderQueue_Text(TextFormat("%.1f", p->spellCard.timer),
+			                 (int)center.x - 20, (int)center.y - 10, 20, BLUE);
 		}
 				int triSize = 5;
 		if (p->facingRight)
 		{
-			DrawTriangle((Vector2){p->position.x + PLAYER_SIZE,
-			                       p->position.y + PLAYER_SIZE / 2},
-			             (Vector2){p->position.x + PLAYER_SIZE + triSize,
-			                       p->position.y + PLAYER_SIZE / 2 - triSize},
-			             (Vector2){p->position.x + PLAYER_SIZE + triSize,
-			                       p->position.y + PLAYER_SIZE / 2 + triSize},
-			             YELLOW);
+			RenderQueue_Triangle((Vector2){p->position.x + PLAYER_SIZE,
+			                               p->position.y + PLAYER_SIZE / 2},
+			                     (Vector2){p->position.x + PLAYER_SIZE + triSize,
+			                               p->position.y + PLAYER_SIZE / 2 - triSize},
+			                     (Vector2){p->position.x + PLAYER_SIZE + triSize,
+			                               p->position.y + PLAYER_SIZE / 2 + triSize},
+			                     YELLOW);
 		}
 		else
 		{
-			DrawTriangle(
+			RenderQueue_Triangle(
 			    (Vector2){p->position.x, p->position.y + PLAYER_SIZE / 2},
 			    (Vector2){p->position.x - triSize,
 			              p->position.y + PLAYER_SIZE / 2 - triSize},
@@ -585,62 +599,68 @@ void Player_Draw(const Player *p)
 	if (p->isClinging)
 	{
 		int offset = p->wallDirection > 0 ? PLAYER_SIZE : -5;
-		DrawRectangle((int)p->position.x + offset, (int)p->position.y + 10, 5,
-		              20, WHITE);
-	}
-	DrawRectangle((int)p->position.x + 10, (int)p->position.y + 10, 8, 8,
-	              WHITE);
-	DrawRectangle((int)p->position.x + 22, (int)p->position.y + 10, 8, 8,
-	              WHITE);
-	DrawRectangle((int)p->position.x + 12, (int)p->position.y + 12, 4, 4,
-	              BLACK);
-	DrawRectangle((int)p->position.x + 24, (int)p->position.y + 12, 4, 4,
-	              BLACK);
+		RenderQueue_Rectangle((int)p->position.x + offset,
+		                      (int)p->position.y + 10, 5, 20, WHITE);
+	}
+	RenderQueue_Rectangle((int)p->position.x + 10, (int)p->position.y + 10, 8,
+	                      8, WHITE);
+	RenderQueue_Rectangle((int)p->position.x + 22, (int)p->position.y + 10, 8,
+	                      8, WHITE);
+	RenderQueue_Rectangle((int)p->position.x + 12, (int)p->position.y + 12, 4,
+	                      4, BLACK);
+	RenderQueue_Rectangle((int)p->position.x + 24, (int)p->position.y + 12, 4,
+	                      4, BLACK);
 	int barWidth = PLAYER_SIZE;
 	int barHeight = 5;
-	DrawRectangle((int)p->position.x, (int)p->position.y - 10, barWidth,
-	              barHeight, BLACK);
-	DrawRectangle((int)p->position.x, (int)p->position.y - 10,
-	              (int)(barWidth * ((float)p->health / p->maxHealth)),
-	              barHeight, GREEN);
+	RenderQueue_Rectangle((int)p->position.x, (int)p->position.y - 10, barWidth,
+	                      barHeight, BLACK);
+	RenderQueue_Rectangle((int)p->position.x, (int)p->position.y - 10,
+	                      (int)(barWidth * ((float)p->health / p->maxHealth)),
+	                      barHeight, GREEN);
 	if (p->dashCooldown > 0)
 	{
 		float cooldownPercent = 1.0f - (p->dashCooldown / 1.0f);
-		DrawRectangle((int)p->position.x, (int)p->position.y - 4, barWidth, 3,
-		              DARKGRAY);
-		DrawRectangle((int)p->position.x, (int)p->position.y - 4,
-		              (int)(barWidth * cooldownPercent), 3, YELLOW);
+		RenderQueue_Rectangle((int)p->position.x, (int)p->position.y - 4,
+		                      barWidth, 3, DARKGRAY);
+		RenderQueue_Rectangle((int)p->position.x, (int)p->position.y - 4,
+		                      (int)(barWidth * cooldownPercent), 3, YELLOW);
 	}
 	else
 	{
-		DrawRectangle((int)p->position.x, (int)p->position.y - 4, barWidth, 3,
-		              GOLD);
+		RenderQueue_Rectangle((int)p->position.x, (int)p->position.y - 4,
+		                      barWidth, 3, GOLD);
 	}
 	if (p->isFloating)
 	{
 		float floatPercent = p->floatTimer / 2.5f;
-		DrawRectangle((int)p->position.x, (int)p->position.y + PLAYER_SIZE + 2,
-		              barWidth, 3, DARKBLUE);
-		DrawRectangle((int)p->position.x, (int)p->position.y + PLAYER_SIZE + 2,
-		              (int)(barWidth * floatPercent), 3, SKYBLUE);
+		RenderQueue_Rectangle((int)p->position.x,
+		                      (int)p->position.y + PLAYER_SIZE + 2, barWidth, 3,
+		                      DARKBLUE);
+		RenderQueue_Rectangle((int)p->position.x,
+		                      (int)p->position.y + PLAYER_SIZE + 2,
+		                      (int)(barWidth * floatPercent), 3, SKYBLUE);
 	}
 	else if (p->floatCooldown > 0)
 	{
 		float cooldownPercent = 1.0f - (p->floatCooldown / 4.0f);
-		DrawRectangle((int)p->position.x, (int)p->position.y + PLAYER_SIZE + 2,
-		              barWidth, 3, DARKGRAY);
-		DrawRectangle((int)p->position.x, (int)p->position.y + PLAYER_SIZE + 2,
-		              (int)(barWidth * cooldownPercent), 3, LIGHTGRAY);
+		RenderQueue_Rectangle((int)p->position.x,
+		                      (int)p->position.y + PLAYER_SIZE + 2, barWidth, 3,
+		                      DARKGRAY);
+		RenderQueue_Rectangle((int)p->position.x,
+		                      (int)p->position.y + PLAYER_SIZE + 2,
+		                      (int)(barWidth * cooldownPercent), 3, LIGHTGRAY);
 	}
 	else
 	{
-		DrawRectangle((int)p->position.x, (int)p->position.y + PLAYER_SIZE + 2,
-		              barWidth, 3, SKYBLUE);
+		RenderQueue_Rectangle((int)p->position.x,
+		                      (int)p->position.y + PLAYER_SIZE + 2, barWidth, 3,
+		                      SKYBLUE);
 	}
 }
 
 void Player_DrawHitbox(const Player *p)
 {
+	RenderQueue_SetLayer(RENDER_LAYER_OVERLAY);
 	// Draw hitbox visualization when ducking or slowing down
 	if (p->isDucking || p->isSlowingDown)
 	{
@@ -657,10 +677,11 @@ void Player_DrawHitbox(const Player *p)
 			hitboxColor = (Color){0, 255, 255, 120};
 		}
 		
-		DrawRectangleRec(hitbox, hitboxColor);
-		DrawRectangleLinesEx(hitbox, 2, (Color){hitboxColor.r, hitboxColor.g, hitboxColor.b, 255});
+		RenderQueue_RectangleRec(hitbox, hitboxColor);
+		RenderQueue_RectangleLinesEx(hitbox, 2, (Color){hitboxColor.r, hitboxColor.g, hitboxColor.b, 255});
 	}
 }
+#endif
 
 Rectangle Player_GetBounds(const Player *p)
 {
@@ -52,7 +52,6 @@ typedef struct
 	int animFrame;
 	float animTimer;
 	bool facingRight;
-	Texture2D spriteSheet;
 	bool hasSprite;
 	bool isSlowingDown;
 	bool isDucking;
@@ -63,9 +62,25 @@ typedef struct
 	float parryCooldown;       // Cooldown between parry attempts
 	bool isParryActive;        // Whether player is currently in parry window
 } Player;
+// What the player asked for this tick. The game reads it from the
+// keyboard; tools can script it instead.
+typedef struct
+{
+	bool left;
+	bool right;
+	bool up;       // jump, W or Up held
+	bool down;
+	bool jumpPressed;
+	bool dashPressed;
+	bool floatPressed;
+	bool spellcardPressed;
+	bool cling;
+	bool slowDown;
+} PlayerInput;
+PlayerInput Player_ReadInput(const KeyBindings *keys);
 void Player_Init(Player *p, Vector2 spawn);
 void Player_Update(Player *p, float dt, Assets *assets,
-                   const KeyBindings *keys);
+                   const PlayerInput *input);
 void Player_Draw(const Player *p);
 void Player_DrawHitbox(const Player *p);
 void Player_TakeDamage(Player *p, int amount);
@@ -0,0 +1,162 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "profiler.h"
+
+#ifdef PROFILER_ENABLED
+// Each section's time is summed over a frame (a section may be entered
+// many times) and then pushed into a ring of recent frames, which the
+// overlay averages for the table and draws as a stacked graph.
+static const char *sectionNames[PROFILE_SECTION_COUNT] = {
+    "Player",     "Physics",    "Spawners",    "Bullets",
+    "Collisions", "Collect",    "Camera",      "Level draw",
+    "Bullet draw", "Flush",     "HUD"};
+static const Color sectionColors[PROFILE_SECTION_COUNT] = {
+    SKYBLUE, BLUE,   ORANGE, RED,     MAROON, GREEN,
+    LIME,    PURPLE, PINK,   MAGENTA, YELLOW};
+
+static double sectionStart[PROFILE_SECTION_COUNT];
+static float sectionTime[PROFILE_SECTION_COUNT];
+static float history[PROFILER_HISTORY][PROFILE_SECTION_COUNT];
+static float frameHistory[PROFILER_HISTORY];
+static int historyHead = 0;
+static int historyCount = 0;
+static bool visible = false;
+
+void Profiler_Begin(ProfileSection section)
+{
+	sectionStart[section] = GetTime();
+}
+void Profiler_End(ProfileSection section)
+{
+	sectionTime[section] += (float)(GetTime() - sectionStart[section]);
+}
+// Closes the frame that just ended; called once at the top of each update.
+void Profiler_NewFrame(float frameTime)
+{
+	for (int i = 0; i < PROFILE_SECTION_COUNT; i++)
+	{
+		history[historyHead][i] = sectionTime[i];
+		sectionTime[i] = 0.0f;
+	}
+	frameHistory[historyHead] = frameTime;
+	historyHead = (historyHead + 1) % PROFILER_HISTORY;
+	if (historyCount < PROFILER_HISTORY)
+		historyCount++;
+}
+void Profiler_Toggle(void) { visible = !visible; }
+// The frame Profiler_NewFrame just closed, in milliseconds per section.
+bool Profiler_GetLastFrame(float sectionMs[PROFILE_SECTION_COUNT])
+{
+	if (historyCount == 0)
+		return false;
+	int index = (historyHead - 1 + PROFILER_HISTORY) % PROFILER_HISTORY;
+	for (int i = 0; i < PROFILE_SECTION_COUNT; i++)
+		sectionMs[i] = history[index][i] * 1000.0f;
+	return true;
+}
+const char *Profiler_GetSectionName(ProfileSection section)
+{
+	return sectionNames[section];
+}
+// Drawn in HUD coordinates, over the right side of the screen.
+void Profiler_Draw(void)
+{
+	if (!visible || historyCount == 0)
+		return;
+	const int x = SCREEN_WIDTH - 250;
+	const int y = 10;
+	const int graphHeight = 80;
+	const float msPerPixel = 33.3f / graphHeight;
+	int rows = PROFILE_SECTION_COUNT + 1;
+	DrawRectangle(x - 10, y - 5, 250, rows * 14 + graphHeight + 20,
+	              (Color){0, 0, 0, 200});
+
+	// Table: per-section average over the recent frames, in milliseconds.
+	int averaged = historyCount < PROFILER_AVERAGE_FRAMES
+	                   ? historyCount
+	                   : PROFILER_AVERAGE_FRAMES;
+	float frameMs = 0.0f;
+	for (int f = 0; f < averaged; f++)
+	{
+		int index =
+		    (historyHead - 1 - f + PROFILER_HISTORY) % PROFILER_HISTORY;
+		frameMs += frameHistory[index] * 1000.0f;
+	}
+	frameMs /= averaged;
+	DrawText(TextFormat("Frame %6.2f ms", frameMs), x, y, 12, WHITE);
+	for (int i = 0; i < PROFILE_SECTION_COUNT; i++)
+	{
+		float ms = 0.0f;
+		for (int f = 0; f < averaged; f++)
+		{
+			int index =
+			    (historyHead - 1 - f + PROFILER_HISTORY) % PROFILER_HISTORY;
+			ms += history[index][i] * 1000.0f;
+		}
+		ms /= averaged;
+		int rowY = y + (i + 1) * 14;
+		DrawRectangle(x, rowY + 2, 8, 8, sectionColors[i]);
+		DrawText(TextFormat("%-12s %6.3f ms", sectionNames[i], ms), x + 14,
+		         rowY, 12, LIGHTGRAY);
+	}
+
+	// Graph: one column per frame, oldest on the left. Sections stack from
+	// the bottom; the gray cap is the rest of the frame (waiting on vsync,
+	// audio, untimed code).
+	int graphY = y + rows * 14 + 5;
+	int columnWidth = 230 / PROFILER_HISTORY > 0 ? 230 / PROFILER_HISTORY : 1;
+	for (int f = 0; f < historyCount; f++)
+	{
+		int index = (historyHead - historyCount + f + PROFILER_HISTORY) %
+		            PROFILER_HISTORY;
+		int columnX = x + f * columnWidth;
+		float bottom = (float)(graphY + graphHeight);
+		float frameTop = bottom - frameHistory[index] * 1000.0f / msPerPixel;
+		if (frameTop < graphY)
+			frameTop = (float)graphY;
+		DrawRectangle(columnX, (int)frameTop, columnWidth,
+		              (int)(bottom - frameTop), DARKGRAY);
+		for (int i = 0; i < PROFILE_SECTION_COUNT; i++)
+		{
+			float height = history[index][i] * 1000.0f / msPerPixel;
+			if (bottom - height < graphY)
+				height = bottom - graphY;
+			if (height <= 0.0f)
+				continue;
+			DrawRectangle(columnX, (int)(bottom - height), columnWidth,
+			              (int)height + 1, sectionColors[i]);
+			bottom -= height;
+		}
+	}
+	// 60 FPS budget line.
+	int budgetY = graphY + graphHeight - (int)(16.7f / msPerPixel);
+	DrawLine(x, budgetY, x + 230, budgetY, (Color){255, 255, 255, 120});
+}
+#else
+void Profiler_Begin(ProfileSection section) {}
+void Profiler_End(ProfileSection section) {}
+void Profiler_NewFrame(float frameTime) {}
+void Profiler_Toggle(void) {}
+void Profiler_Draw(void) {}
+bool Profiler_GetLastFrame(float sectionMs[PROFILE_SECTION_COUNT])
+{
+	return false;
+}
+const char *Profiler_GetSectionName(ProfileSection section) { return ""; }
+#endif
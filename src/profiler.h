@@ -0,0 +1,39 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+#include "config.h"
+// Scoped CPU timers shown by the F3 overlay. Release builds (-DNDEBUG)
+// compile the timers out and the overlay functions do nothing, as does the
+// headless simulation library (-DCIRNO_HEADLESS).
+#if !defined(NDEBUG) && !defined(CIRNO_HEADLESS)
+#define PROFILER_ENABLED
+#endif
+typedef enum
+{
+	PROFILE_PLAYER,
+	PROFILE_PHYSICS,
+	PROFILE_SPAWNERS,
+	PROFILE_BULLETS,
+	PROFILE_COLLISIONS,
+	PROFILE_COLLECT,
+	PROFILE_CAMERA,
+	PROFILE_LEVEL_DRAW,
+	PROFILE_BULLET_DRAW,
+	PROFILE_FLUSH,
+	PROFILE_HUD,
+	PROFILE_SECTION_COUNT
+} ProfileSection;
+#ifdef PROFILER_ENABLED
+#define PROFILE_BEGIN(section) Profiler_Begin(section)
+#define PROFILE_END(section) Profiler_End(section)
+#else
+#define PROFILE_BEGIN(section) ((void)0)
+#define PROFILE_END(section) ((void)0)
+#endif
+void Profiler_Begin(ProfileSection section);
+void Profiler_End(ProfileSection section);
+void Profiler_NewFrame(float frameTime);
+void Profiler_Toggle(void);
+void Profiler_Draw(void);
+bool Profiler_GetLastFrame(float sectionMs[PROFILE_SECTION_COUNT]);
+const char *Profiler_GetSectionName(ProfileSection section);
+#endif
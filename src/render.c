@@ -0,0 +1,165 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "render.h"
+#include "memtrack.h"
+#include <math.h>
+#include <stddef.h>
+
+// The world is drawn into an offscreen target sized to the window times the
+// render scale and then stretched over the window. The HUD is drawn after
+// that straight to the backbuffer, so text stays sharp at any scale. Only
+// gameplay screens draw the world; menus, the visual novel and the editor
+// are cheap and always draw at full resolution, as the settings screen says.
+static const Settings *renderSettings = NULL;
+static RenderTexture2D worldTarget = {0};
+static bool targetLoaded = false;
+static float currentScale = 1.0f;
+static float averageFrameTime = 0.0f;
+static float overBudgetTime = 0.0f;
+static float underBudgetTime = 0.0f;
+
+// Largest 4:3 region of the window, centered. Everything in the world and
+// the HUD uses SCREEN_WIDTH x SCREEN_HEIGHT logical coordinates inside it.
+static Rectangle Render_GetViewport(void)
+{
+	float screenW = (float)GetScreenWidth();
+	float screenH = (float)GetScreenHeight();
+	float fit = fminf(screenW / SCREEN_WIDTH, screenH / SCREEN_HEIGHT);
+	float w = SCREEN_WIDTH * fit;
+	float h = SCREEN_HEIGHT * fit;
+	return (Rectangle){(screenW - w) / 2, (screenH - h) / 2, w, h};
+}
+static float Render_GetConfiguredScale(void)
+{
+	if (!renderSettings)
+		return RENDER_SCALE_MAX;
+	float scale = renderSettings->renderScale;
+	if (scale < RENDER_SCALE_MIN)
+		scale = RENDER_SCALE_MIN;
+	if (scale > RENDER_SCALE_MAX)
+		scale = RENDER_SCALE_MAX;
+	return scale;
+}
+void Render_Init(const Settings *settings)
+{
+	renderSettings = settings;
+	currentScale = Render_GetConfiguredScale();
+	averageFrameTime = RENDER_FRAME_BUDGET;
+	overBudgetTime = 0.0f;
+	underBudgetTime = 0.0f;
+}
+void Render_Unload(void)
+{
+	if (targetLoaded)
+	{
+		Mem_UntrackTexture(&worldTarget.texture);
+		UnloadRenderTexture(worldTarget);
+		targetLoaded = false;
+	}
+}
+// Dynamic mode walks the scale down in small steps while frames run over
+// budget and back up once there is plenty of headroom again. The two
+// thresholds and timers keep it from bouncing between sizes every frame.
+void Render_Update(float frameTime)
+{
+	float configured = Render_GetConfiguredScale();
+	if (!renderSettings || !renderSettings->dynamicResolution)
+	{
+		currentScale = configured;
+		return;
+	}
+	averageFrameTime = averageFrameTime * 0.9f + frameTime * 0.1f;
+	if (averageFrameTime > RENDER_FRAME_BUDGET * 1.1f)
+	{
+		overBudgetTime += frameTime;
+		underBudgetTime = 0.0f;
+	}
+	else if (averageFrameTime < RENDER_FRAME_BUDGET * 0.7f)
+	{
+		underBudgetTime += frameTime;
+		overBudgetTime = 0.0f;
+	}
+	else
+	{
+		overBudgetTime = 0.0f;
+		underBudgetTime = 0.0f;
+	}
+	if (overBudgetTime > 0.25f && currentScale > RENDER_SCALE_MIN)
+	{
+		currentScale -= RENDER_SCALE_STEP;
+		overBudgetTime = 0.0f;
+	}
+	else if (underBudgetTime > 2.0f && currentScale < configured)
+	{
+		currentScale += RENDER_SCALE_STEP;
+		underBudgetTime = 0.0f;
+	}
+	if (currentScale < RENDER_SCALE_MIN)
+		currentScale = RENDER_SCALE_MIN;
+	if (currentScale > configured)
+		currentScale = configured;
+}
+void Render_BeginWorld(Camera2D camera)
+{
+	Rectangle viewport = Render_GetViewport();
+	int width = (int)(viewport.width * currentScale + 0.5f);
+	int height = (int)(viewport.height * currentScale + 0.5f);
+	if (width < 1)
+		width = 1;
+	if (height < 1)
+		height = 1;
+	if (!targetLoaded || worldTarget.texture.width != width ||
+	    worldTarget.texture.height != height)
+	{
+		Render_Unload();
+		worldTarget = LoadRenderTexture(width, height);
+		SetTextureFilter(worldTarget.texture, TEXTURE_FILTER_BILINEAR);
+		Mem_TrackTexture(MEM_TAG_OTHER, &worldTarget.texture);
+		targetLoaded = true;
+	}
+	BeginTextureMode(worldTarget);
+	ClearBackground(SKY_COLOR);
+	// Same view of the world, just at the target's pixel density.
+	float k = (float)width / SCREEN_WIDTH;
+	Camera2D scaled = camera;
+	scaled.offset.x *= k;
+	scaled.offset.y *= k;
+	scaled.zoom *= k;
+	BeginMode2D(scaled);
+}
+void Render_EndWorld(void)
+{
+	EndMode2D();
+	EndTextureMode();
+	// Render textures are stored upside down, hence the negative height.
+	Rectangle source = {0, 0, (float)worldTarget.texture.width,
+	                    -(float)worldTarget.texture.height};
+	DrawTexturePro(worldTarget.texture, source, Render_GetViewport(),
+	               (Vector2){0, 0}, 0.0f, WHITE);
+}
+void Render_BeginHud(void)
+{
+	Rectangle viewport = Render_GetViewport();
+	Camera2D hud = {0};
+	hud.offset = (Vector2){viewport.x, viewport.y};
+	hud.zoom = viewport.width / SCREEN_WIDTH;
+	BeginMode2D(hud);
+}
+void Render_EndHud(void) { EndMode2D(); }
+float Render_GetScale(void) { return currentScale; }
@@ -0,0 +1,13 @@
+#ifndef RENDER_H
+#define RENDER_H
+#include "config.h"
+#include "raylib.h"
+void Render_Init(const Settings *settings);
+void Render_Unload(void);
+void Render_Update(float frameTime);
+void Render_BeginWorld(Camera2D camera);
+void Render_EndWorld(void);
+void Render_BeginHud(void);
+void Render_EndHud(void);
+float Render_GetScale(void);
+#endif
@@ -0,0 +1,293 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "renderqueue.h"
+#include <stdlib.h>
+#include <string.h>
+
+// World drawing records commands here instead of calling raylib straight
+// away. Flush sorts them by (layer, texture, record order) and submits, so
+// raylib only has to break its batch when the texture actually changes.
+// Moving a command ahead of an earlier one with another texture is only
+// safe when the two cannot overlap, so layers that may overlap leave the
+// texture out of the key and draw in record order. Recording never touches
+// the GPU; only Flush does.
+typedef enum
+{
+	RENDER_CMD_QUAD,
+	RENDER_CMD_RECT,
+	RENDER_CMD_RECT_LINES,
+	RENDER_CMD_CIRCLE,
+	RENDER_CMD_CIRCLE_LINES,
+	RENDER_CMD_RING,
+	RENDER_CMD_LINE,
+	RENDER_CMD_TRIANGLE,
+	RENDER_CMD_TEXT
+} RenderCommandType;
+
+typedef struct
+{
+	unsigned long long key; // layer | texture slot on grid layers | sequence
+	unsigned char type;
+	unsigned char texture;
+	Color color;
+	union
+	{
+		struct
+		{
+			Rectangle source;
+			Rectangle dest;
+		} quad;
+		struct
+		{
+			Rectangle rec;
+			float thick;
+		} rect;
+		struct
+		{
+			Vector2 center;
+			float radius;
+			float innerRadius;
+			float startAngle;
+			float endAngle;
+			int segments;
+		} circle;
+		struct
+		{
+			Vector2 v1;
+			Vector2 v2;
+			Vector2 v3;
+			float thick;
+		} prim;
+		struct
+		{
+			int x;
+			int y;
+			int fontSize;
+			int offset; // into textPool
+		} text;
+	} data;
+} RenderCommand;
+
+static RenderCommand commands[RENDER_QUEUE_CAPACITY];
+static int commandCount = 0;
+static Texture2D textures[RENDER_QUEUE_MAX_TEXTURES];
+static int textureCount = 0;
+static char textPool[RENDER_QUEUE_TEXT_POOL];
+static int textPoolUsed = 0;
+static RenderLayer currentLayer = RENDER_LAYER_TILES;
+static int lastBatchCount = 0;
+// Layers drawn one quad per grid cell, where nothing overlaps.
+static const bool groupByTexture[RENDER_LAYER_COUNT] = {
+    [RENDER_LAYER_BACKGROUND] = true, [RENDER_LAYER_TILES] = true};
+
+void RenderQueue_SetLayer(RenderLayer layer)
+{
+	if (layer >= 0 && layer < RENDER_LAYER_COUNT)
+		currentLayer = layer;
+}
+static int RenderQueue_TextureSlot(Texture2D texture)
+{
+	for (int i = 0; i < textureCount; i++)
+	{
+		if (textures[i].id == texture.id)
+			return i;
+	}
+	if (textureCount >= RENDER_QUEUE_MAX_TEXTURES)
+		RenderQueue_Flush();
+	textures[textureCount] = texture;
+	return textureCount++;
+}
+// Returns the next free command with its sort key filled in. A full buffer
+// is submitted early; everything recorded later draws on top, which is the
+// order it would have had anyway.
+static RenderCommand *RenderQueue_Push(RenderCommandType type,
+                                       Texture2D texture, Color color)
+{
+	if (commandCount >= RENDER_QUEUE_CAPACITY)
+		RenderQueue_Flush();
+	int slot = RenderQueue_TextureSlot(texture);
+	RenderCommand *cmd = &commands[commandCount];
+	unsigned long long group = groupByTexture[currentLayer] ? slot : 0;
+	cmd->key = ((unsigned long long)currentLayer << 48) | (group << 40) |
+	           (unsigned long long)commandCount;
+	cmd->type = (unsigned char)type;
+	cmd->texture = (unsigned char)slot;
+	cmd->color = color;
+	commandCount++;
+	return cmd;
+}
+void RenderQueue_Quad(Texture2D texture, Rectangle source, Rectangle dest,
+                      Color tint)
+{
+	RenderCommand *cmd = RenderQueue_Push(RENDER_CMD_QUAD, texture, tint);
+	cmd->data.quad.source = source;
+	cmd->data.quad.dest = dest;
+}
+void RenderQueue_Rectangle(int posX, int posY, int width, int height,
+                           Color color)
+{
+	RenderQueue_RectangleRec(
+	    (Rectangle){(float)posX, (float)posY, (float)width, (float)height},
+	    color);
+}
+void RenderQueue_RectangleRec(Rectangle rec, Color color)
+{
+	RenderCommand *cmd =
+	    RenderQueue_Push(RENDER_CMD_RECT, GetShapesTexture(), color);
+	cmd->data.rect.rec = rec;
+}
+void RenderQueue_RectangleLinesEx(Rectangle rec, float lineThick, Color color)
+{
+	RenderCommand *cmd =
+	    RenderQueue_Push(RENDER_CMD_RECT_LINES, GetShapesTexture(), color);
+	cmd->data.rect.rec = rec;
+	cmd->data.rect.thick = lineThick;
+}
+void RenderQueue_CircleV(Vector2 center, float radius, Color color)
+{
+	RenderCommand *cmd =
+	    RenderQueue_Push(RENDER_CMD_CIRCLE, GetShapesTexture(), color);
+	cmd->data.circle.center = center;
+	cmd->data.circle.radius = radius;
+}
+void RenderQueue_CircleLines(int centerX, int centerY, float radius,
+                             Color color)
+{
+	RenderCommand *cmd =
+	    RenderQueue_Push(RENDER_CMD_CIRCLE_LINES, GetShapesTexture(), color);
+	cmd->data.circle.center = (Vector2){(float)centerX, (float)centerY};
+	cmd->data.circle.radius = radius;
+}
+void RenderQueue_Ring(Vector2 center, float innerRadius, float outerRadius,
+                      float startAngle, float endAngle, int segments,
+                      Color color)
+{
+	RenderCommand *cmd =
+	    RenderQueue_Push(RENDER_CMD_RING, GetShapesTexture(), color);
+	cmd->data.circle.center = center;
+	cmd->data.circle.radius = outerRadius;
+	cmd->data.circle.innerRadius = innerRadius;
+	cmd->data.circle.startAngle = startAngle;
+	cmd->data.circle.endAngle = endAngle;
+	cmd->data.circle.segments = segments;
+}
+void RenderQueue_LineEx(Vector2 startPos, Vector2 endPos, float thick,
+                        Color color)
+{
+	RenderCommand *cmd =
+	    RenderQueue_Push(RENDER_CMD_LINE, GetShapesTexture(), color);
+	cmd->data.prim.v1 = startPos;
+	cmd->data.prim.v2 = endPos;
+	cmd->data.prim.thick = thick;
+}
+void RenderQueue_Triangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color)
+{
+	RenderCommand *cmd =
+	    RenderQueue_Push(RENDER_CMD_TRIANGLE, GetShapesTexture(), color);
+	cmd->data.prim.v1 = v1;
+	cmd->data.prim.v2 = v2;
+	cmd->data.prim.v3 = v3;
+}
+void RenderQueue_Text(const char *text, int posX, int posY, int fontSize,
+                      Color color)
+{
+	int len = (int)strlen(text) + 1;
+	if (textPoolUsed + len > RENDER_QUEUE_TEXT_POOL)
+		RenderQueue_Flush();
+	if (len > RENDER_QUEUE_TEXT_POOL)
+		return;
+	RenderCommand *cmd =
+	    RenderQueue_Push(RENDER_CMD_TEXT, GetFontDefault().texture, color);
+	memcpy(textPool + textPoolUsed, text, len);
+	cmd->data.text.x = posX;
+	cmd->data.text.y = posY;
+	cmd->data.text.fontSize = fontSize;
+	cmd->data.text.offset = textPoolUsed;
+	textPoolUsed += len;
+}
+static int RenderQueue_CompareCommands(const void *a, const void *b)
+{
+	unsigned long long ka = ((const RenderCommand *)a)->key;
+	unsigned long long kb = ((const RenderCommand *)b)->key;
+	return (ka > kb) - (ka < kb);
+}
+static void RenderQueue_Submit(const RenderCommand *cmd)
+{
+	switch (cmd->type)
+	{
+	case RENDER_CMD_QUAD:
+		DrawTexturePro(textures[cmd->texture], cmd->data.quad.source,
+		               cmd->data.quad.dest, (Vector2){0, 0}, 0, cmd->color);
+		break;
+	case RENDER_CMD_RECT:
+		DrawRectangleRec(cmd->data.rect.rec, cmd->color);
+		break;
+	case RENDER_CMD_RECT_LINES:
+		DrawRectangleLinesEx(cmd->data.rect.rec, cmd->data.rect.thick,
+		                     cmd->color);
+		break;
+	case RENDER_CMD_CIRCLE:
+		DrawCircleV(cmd->data.circle.center, cmd->data.circle.radius,
+		            cmd->color);
+		break;
+	case RENDER_CMD_CIRCLE_LINES:
+		DrawCircleLinesV(cmd->data.circle.center, cmd->data.circle.radius,
+		                 cmd->color);
+		break;
+	case RENDER_CMD_RING:
+		DrawRing(cmd->data.circle.center, cmd->data.circle.innerRadius,
+		         cmd->data.circle.radius, cmd->data.circle.startAngle,
+		         cmd->data.circle.endAngle, cmd->data.circle.segments,
+		         cmd->color);
+		break;
+	case RENDER_CMD_LINE:
+		DrawLineEx(cmd->data.prim.v1, cmd->data.prim.v2,
+		           cmd->data.prim.thick, cmd->color);
+		break;
+	case RENDER_CMD_TRIANGLE:
+		DrawTriangle(cmd->data.prim.v1, cmd->data.prim.v2, cmd->data.prim.v3,
+		             cmd->color);
+		break;
+	case RENDER_CMD_TEXT:
+		DrawText(textPool + cmd->data.text.offset, cmd->data.text.x,
+		         cmd->data.text.y, cmd->data.text.fontSize, cmd->color);
+		break;
+	}
+}
+void RenderQueue_Flush(void)
+{
+	qsort(commands, commandCount, sizeof(RenderCommand),
+	      RenderQueue_CompareCommands);
+	int batches = 0;
+	int lastTexture = -1;
+	for (int i = 0; i < commandCount; i++)
+	{
+		if (commands[i].texture != lastTexture)
+		{
+			lastTexture = commands[i].texture;
+			batches++;
+		}
+		RenderQueue_Submit(&commands[i]);
+	}
+	lastBatchCount = batches;
+	commandCount = 0;
+	textureCount = 0;
+	textPoolUsed = 0;
+}
+int RenderQueue_GetLastBatchCount(void) { return lastBatchCount; }
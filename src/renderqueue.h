@@ -0,0 +1,40 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+#include "config.h"
+#include "raylib.h"
+// Draw order of the world, back to front. Within a layer commands keep the
+// order they were recorded in, except that the tile grid layers, whose
+// quads never overlap, are grouped by texture.
+typedef enum
+{
+	RENDER_LAYER_BACKGROUND,
+	RENDER_LAYER_TILES,
+	RENDER_LAYER_SPAWNERS,
+	RENDER_LAYER_BULLETS,
+	RENDER_LAYER_COLLECTIBLES,
+	RENDER_LAYER_PLAYER,
+	RENDER_LAYER_OVERLAY,
+	RENDER_LAYER_COUNT
+} RenderLayer;
+void RenderQueue_SetLayer(RenderLayer layer);
+// Same arguments as the raylib calls they stand in for.
+void RenderQueue_Quad(Texture2D texture, Rectangle source, Rectangle dest,
+                      Color tint);
+void RenderQueue_Rectangle(int posX, int posY, int width, int height,
+                           Color color);
+void RenderQueue_RectangleRec(Rectangle rec, Color color);
+void RenderQueue_RectangleLinesEx(Rectangle rec, float lineThick, Color color);
+void RenderQueue_CircleV(Vector2 center, float radius, Color color);
+void RenderQueue_CircleLines(int centerX, int centerY, float radius,
+                             Color color);
+void RenderQueue_Ring(Vector2 center, float innerRadius, float outerRadius,
+                      float startAngle, float endAngle, int segments,
+                      Color color);
+void RenderQueue_LineEx(Vector2 startPos, Vector2 endPos, float thick,
+                        Color color);
+void RenderQueue_Triangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color);
+void RenderQueue_Text(const char *text, int posX, int posY, int fontSize,
+                      Color color);
+void RenderQueue_Flush(void);
+int RenderQueue_GetLastBatchCount(void);
+#endif
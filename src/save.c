@@ -17,8 +17,13 @@
  */
 
 #include "save.h"
+#include "memtrack.h"
+#include "serial.h"
+#include "trace.h"
+#include "writer.h"
 #include <dirent.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -26,52 +31,312 @@
 #include <direct.h>
 #define mkdir(dir, mode) _mkdir(dir)
 #endif
+
+// Saves use the tagged encoding from serial.c. Everything the load screen
+// shows comes first as plain fields; the rest of the progress sits in one
+// section that listing saves steps over without decoding.
+#define SAVE_MAGIC "CSAV"
+// Field ids; never reuse a retired one.
+#define SAVE_FIELD_NAME 1
+#define SAVE_FIELD_LEVEL 2
+#define SAVE_FIELD_DEATHS 3
+#define SAVE_FIELD_HEALTH 4
+#define SAVE_FIELD_TOTAL_SCORE 5
+#define SAVE_FIELD_LEVEL_SCORE 6
+#define SAVE_FIELD_HEALTH_POINTS 7
+#define SAVE_FIELD_SPELL_CARD 8
+#define SAVE_FIELD_VALID 9
+#define SAVE_FIELD_PROGRESS 10
+// Inside SAVE_FIELD_PROGRESS
+#define SAVE_FIELD_PLAYER_NAME 1
+#define SAVE_FIELD_TOTAL_LEVELS 2
+#define SAVE_FIELD_LEVELS_COMPLETED 3
+#define SAVE_FIELD_LEVEL_DEATHS 4 // repeated, in level order
+#define SAVE_FIELD_LEVEL_DONE 5   // repeated, in level order
+#define SAVE_FIELD_ACHIEVEMENTS 6
+
+// Version 1 saves were this header followed by the raw GameData; older
+// ones are a bare GameData. Both are still read.
+typedef struct
+{
+	char magic[4];
+	int version;
+	int dataSize;
+	SaveMetadata meta;
+} SaveHeaderV1;
+
+// What the load screen lists. Filled by one directory scan and then kept
+// up to date by Save_Write and Save_DeleteSave, so browsing saves does no
+// I/O per frame.
+static SaveMetadata saveList[MAX_SAVE_FILES];
+static char saveListFiles[MAX_SAVE_FILES][256];
+static int saveListCount = 0;
+static bool saveListValid = false;
+
+static void Save_FillMetadata(SaveMetadata *meta, const GameData *data)
+{
+	memset(meta, 0, sizeof(SaveMetadata));
+	snprintf(meta->saveName, sizeof(meta->saveName), "%s", data->saveName);
+	meta->currentLevel = data->currentLevel;
+	meta->deathCount = data->deathCount;
+	meta->health = data->health;
+	meta->totalScore = data->totalScore;
+	meta->currentLevelScore = data->currentLevelScore;
+	meta->healthPoints = data->healthPoints;
+	meta->canSpellCard = data->canSpellCard;
+	meta->isValid = data->isValid;
+}
+static int Save_FindListed(const char *filename)
+{
+	for (int i = 0; i < saveListCount; i++)
+	{
+		if (strcmp(saveListFiles[i], filename) == 0)
+			return i;
+	}
+	return -1;
+}
+static void Save_SetListed(const char *filename, const SaveMetadata *meta)
+{
+	if (!saveListValid)
+		return;
+	int index = Save_FindListed(filename);
+	if (index < 0)
+	{
+		if (saveListCount >= MAX_SAVE_FILES)
+			return;
+		index = saveListCount++;
+		strncpy(saveListFiles[index], filename, 255);
+		saveListFiles[index][255] = '\0';
+	}
+	saveList[index] = *meta;
+}
+static void Save_DeserializeProgress(GameData *data, SerialReader *r)
+{
+	SerialField field;
+	int deaths = 0;
+	int done = 0;
+	while (SerialReader_Next(r, &field))
+	{
+		switch (field.id)
+		{
+		case SAVE_FIELD_PLAYER_NAME:
+			Serial_GetString(&field, data->playerName,
+			                 sizeof(data->playerName));
+			break;
+		case SAVE_FIELD_TOTAL_LEVELS:
+			data->totalLevels = Serial_GetInt(&field);
+			break;
+		case SAVE_FIELD_LEVELS_COMPLETED:
+			data->levelsCompleted = Serial_GetInt(&field);
+			break;
+		case SAVE_FIELD_LEVEL_DEATHS:
+			if (deaths < MAX_LEVELS)
+				data->levelDeaths[deaths++] = Serial_GetInt(&field);
+			break;
+		case SAVE_FIELD_LEVEL_DONE:
+			if (done < MAX_LEVELS)
+				data->levelProgress[done++] = Serial_GetInt(&field) != 0;
+			break;
+		case SAVE_FIELD_ACHIEVEMENTS:
+		{
+			SerialReader section;
+			SerialReader_OpenSection(&section, &field);
+			Achievement_Deserialize(&data->achievements, &section);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+static void Save_Serialize(SerialWriter *w, const GameData *data)
+{
+	SerialWriter_Begin(w, SAVE_MAGIC, SAVE_FORMAT_VERSION);
+	SerialWriter_PutString(w, SAVE_FIELD_NAME, data->saveName);
+	SerialWriter_PutInt(w, SAVE_FIELD_LEVEL, data->currentLevel);
+	SerialWriter_PutInt(w, SAVE_FIELD_DEATHS, data->deathCount);
+	SerialWriter_PutInt(w, SAVE_FIELD_HEALTH, data->health);
+	SerialWriter_PutInt(w, SAVE_FIELD_TOTAL_SCORE, data->totalScore);
+	SerialWriter_PutInt(w, SAVE_FIELD_LEVEL_SCORE, data->currentLevelScore);
+	SerialWriter_PutInt(w, SAVE_FIELD_HEALTH_POINTS, data->healthPoints);
+	SerialWriter_PutInt(w, SAVE_FIELD_SPELL_CARD, data->canSpellCard);
+	SerialWriter_PutInt(w, SAVE_FIELD_VALID, data->isValid);
+	int progress = SerialWriter_BeginSection(w, SAVE_FIELD_PROGRESS);
+	SerialWriter_PutString(w, SAVE_FIELD_PLAYER_NAME, data->playerName);
+	SerialWriter_PutInt(w, SAVE_FIELD_TOTAL_LEVELS, data->totalLevels);
+	SerialWriter_PutInt(w, SAVE_FIELD_LEVELS_COMPLETED,
+	                    data->levelsCompleted);
+	// Only as far as the last level with anything to record.
+	int levels = MAX_LEVELS;
+	while (levels > 0 && data->levelDeaths[levels - 1] == 0 &&
+	       !data->levelProgress[levels - 1])
+		levels--;
+	for (int i = 0; i < levels; i++)
+	{
+		SerialWriter_PutInt(w, SAVE_FIELD_LEVEL_DEATHS, data->levelDeaths[i]);
+		SerialWriter_PutInt(w, SAVE_FIELD_LEVEL_DONE, data->levelProgress[i]);
+	}
+	int achievements = SerialWriter_BeginSection(w, SAVE_FIELD_ACHIEVEMENTS);
+	Achievement_Serialize(&data->achievements, w);
+	SerialWriter_EndSection(w, achievements);
+	SerialWriter_EndSection(w, progress);
+}
+// Fills whatever fields the save has; the rest keep their defaults.
+static void Save_DeserializeMetadata(SaveMetadata *meta, SerialReader *r,
+                                     GameData *data)
+{
+	SerialField field;
+	while (SerialReader_Next(r, &field))
+	{
+		switch (field.id)
+		{
+		case SAVE_FIELD_NAME:
+			Serial_GetString(&field, meta->saveName, sizeof(meta->saveName));
+			break;
+		case SAVE_FIELD_LEVEL:
+			meta->currentLevel = Serial_GetInt(&field);
+			break;
+		case SAVE_FIELD_DEATHS:
+			meta->deathCount = Serial_GetInt(&field);
+			break;
+		case SAVE_FIELD_HEALTH:
+			meta->health = Serial_GetInt(&field);
+			break;
+		case SAVE_FIELD_TOTAL_SCORE:
+			meta->totalScore = Serial_GetInt(&field);
+			break;
+		case SAVE_FIELD_LEVEL_SCORE:
+			meta->currentLevelScore = Serial_GetInt(&field);
+			break;
+		case SAVE_FIELD_HEALTH_POINTS:
+			meta->healthPoints = Serial_GetInt(&field);
+			break;
+		case SAVE_FIELD_SPELL_CARD:
+			meta->canSpellCard = Serial_GetInt(&field) != 0;
+			break;
+		case SAVE_FIELD_VALID:
+			meta->isValid = Serial_GetInt(&field) != 0;
+			break;
+		case SAVE_FIELD_PROGRESS:
+			if (data)
+			{
+				SerialReader section;
+				SerialReader_OpenSection(&section, &field);
+				Save_DeserializeProgress(data, &section);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
 void Save_Write(const GameData *data, const char *filename)
 {
 	mkdir("saves", 0777);
 	char filepath[512];
 	snprintf(filepath, sizeof(filepath), "saves/%s", filename);
-	FILE *f = fopen(filepath, "wb");
-	if (f)
+	Trace_Begin("Save_Write");
+	// Serialized here, written to disk by the writer thread.
+	SerialWriter w;
+	Save_Serialize(&w, data);
+	if (!w.failed && Writer_Submit(filepath, w.data, w.size))
 	{
-		fwrite(data, sizeof(GameData), 1, f);
-		fclose(f);
+		SaveMetadata meta;
+		Save_FillMetadata(&meta, data);
+		Save_SetListed(filename, &meta);
 	}
+	SerialWriter_Free(&w);
+	Trace_End("Save_Write");
+}
+// Decodes any save format into data and meta; either may be NULL.
+static bool Save_Decode(const unsigned char *bytes, int size, GameData *data,
+                        SaveMetadata *meta)
+{
+	SerialReader r;
+	int version = 0;
+	bool tagged = SerialReader_Open(&r, bytes, size, SAVE_MAGIC, &version) &&
+	              version >= 2;
+	GameData legacy;
+	const GameData *raw = NULL;
+	if (!tagged)
+	{
+		if (size == (int)(sizeof(SaveHeaderV1) + sizeof(GameData)) &&
+		    memcmp(bytes, SAVE_MAGIC, 4) == 0)
+			raw = (const GameData *)(bytes + sizeof(SaveHeaderV1));
+		else if (size == (int)sizeof(GameData))
+			raw = (const GameData *)bytes;
+		else
+			return false;
+	}
+	if (raw)
+	{
+		memcpy(&legacy, raw, sizeof(GameData));
+		Achievement_FixPointers(&legacy.achievements);
+		if (data)
+			*data = legacy;
+		if (meta)
+			Save_FillMetadata(meta, &legacy);
+		return true;
+	}
+	SaveMetadata scratch;
+	if (!meta)
+		meta = &scratch;
+	memset(meta, 0, sizeof(SaveMetadata));
+	if (data)
+	{
+		memset(data, 0, sizeof(GameData));
+		data->totalLevels = BASE_LEVEL_COUNT;
+		data->health = PLAYER_MAX_HEALTH;
+		Achievement_Init(&data->achievements);
+	}
+	meta->health = PLAYER_MAX_HEALTH;
+	Save_DeserializeMetadata(meta, &r, data);
+	if (data)
+	{
+		strcpy(data->saveName, meta->saveName);
+		data->currentLevel = meta->currentLevel;
+		data->deathCount = meta->deathCount;
+		data->health = meta->health;
+		data->totalScore = meta->totalScore;
+		data->currentLevelScore = meta->currentLevelScore;
+		data->healthPoints = meta->healthPoints;
+		data->canSpellCard = meta->canSpellCard;
+		data->isValid = meta->isValid;
+	}
+	return true;
 }
 bool Save_Read(GameData *data, const char *filename)
 {
 	char filepath[512];
 	snprintf(filepath, sizeof(filepath), "saves/%s", filename);
-	FILE *f = fopen(filepath, "rb");
-	if (!f)
+	// A save still queued on the writer would otherwise read as stale.
+	Writer_Flush();
+	int size = 0;
+	unsigned char *bytes = Serial_ReadFile(filepath, &size);
+	if (!bytes)
 		return false;
-	size_t result = fread(data, sizeof(GameData), 1, f);
-	fclose(f);
-	return result == 1;
+	bool ok = Save_Decode(bytes, size, data, NULL);
+	Mem_Free(bytes);
+	return ok;
 }
+// Skips the progress section, so only the leading fields are decoded.
 bool Save_ReadMetadata(SaveMetadata *meta, const char *filename)
 {
-	GameData data;
-	if (!Save_Read(&data, filename))
-	{
+	char filepath[512];
+	snprintf(filepath, sizeof(filepath), "saves/%s", filename);
+	int size = 0;
+	unsigned char *bytes = Serial_ReadFile(filepath, &size);
+	bool ok = bytes && Save_Decode(bytes, size, NULL, meta);
+	Mem_Free(bytes);
+	if (!ok)
 		meta->isValid = false;
-		return false;
-	}
-	strncpy(meta->saveName, data.saveName, sizeof(meta->saveName) - 1);
-	meta->saveName[sizeof(meta->saveName) - 1] = '\0';
-	meta->currentLevel = data.currentLevel;
-	meta->deathCount = data.deathCount;
-	meta->health = data.health;
-	meta->totalScore = data.totalScore;
-	meta->currentLevelScore = data.currentLevelScore;
-	meta->healthPoints = data.healthPoints;
-	meta->canSpellCard = data.canSpellCard;
-	meta->isValid = data.isValid;
-	return true;
+	return ok;
 }
-void Save_GetAllSaveFiles(SaveMetadata *saves, int maxSaves, int *count)
+static void Save_ScanDirectory(void)
 {
-	*count = 0;
+	saveListCount = 0;
+	saveListValid = true;
+	Writer_Flush();
 	DIR *dir = opendir("saves");
 	if (!dir)
 	{
@@ -79,23 +344,47 @@ void Save_GetAllSaveFiles(SaveMetadata *saves, int maxSaves, int *count)
 		return;
 	}
 	struct dirent *entry;
-	while ((entry = readdir(dir)) != NULL && *count < maxSaves)
+	while ((entry = readdir(dir)) != NULL && saveListCount < MAX_SAVE_FILES)
 	{
 		const char *name = entry->d_name;
 		size_t len = strlen(name);
-		if (len > 4 && strcmp(name + len - 4, ".sav") == 0)
+		if (len > 4 && len < 256 && strcmp(name + len - 4, ".sav") == 0)
 		{
-			if (Save_ReadMetadata(&saves[*count], name))
+			if (Save_ReadMetadata(&saveList[saveListCount], name))
 			{
-				(*count)++;
+				strcpy(saveListFiles[saveListCount], name);
+				saveListCount++;
 			}
 		}
 	}
 	closedir(dir);
 }
+// The returned array stays valid until the next save is written, deleted
+// or the list is invalidated.
+const SaveMetadata *Save_GetSaveList(int *count)
+{
+	if (!saveListValid)
+		Save_ScanDirectory();
+	*count = saveListCount;
+	return saveList;
+}
+// Forces the next Save_GetSaveList to rescan, for files that changed
+// behind the game's back.
+void Save_InvalidateList(void) { saveListValid = false; }
 void Save_DeleteSave(const char *filename)
 {
 	char filepath[512];
 	snprintf(filepath, sizeof(filepath), "saves/%s", filename);
+	// So a queued write cannot bring the file back afterwards.
+	Writer_Flush();
 	remove(filepath);
+	int index = Save_FindListed(filename);
+	if (index < 0)
+		return;
+	saveListCount--;
+	for (int i = index; i < saveListCount; i++)
+	{
+		saveList[i] = saveList[i + 1];
+		strcpy(saveListFiles[i], saveListFiles[i + 1]);
+	}
 }
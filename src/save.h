@@ -16,6 +16,7 @@ typedef struct
 void Save_Write(const GameData *data, const char *filename);
 bool Save_Read(GameData *data, const char *filename);
 bool Save_ReadMetadata(SaveMetadata *meta, const char *filename);
-void Save_GetAllSaveFiles(SaveMetadata *saves, int maxSaves, int *count);
+const SaveMetadata *Save_GetSaveList(int *count);
+void Save_InvalidateList(void);
 void Save_DeleteSave(const char *filename);
 #endif
@@ -0,0 +1,254 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "serial.h"
+#include "memtrack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void SerialWriter_Put(SerialWriter *w, const void *src, int count)
+{
+	if (w->failed)
+		return;
+	if (w->size + count > w->capacity)
+	{
+		int capacity = w->capacity > 0 ? w->capacity : 256;
+		while (capacity < w->size + count)
+			capacity *= 2;
+		unsigned char *data =
+		    (unsigned char *)Mem_Realloc(MEM_TAG_SAVES, w->data, capacity);
+		if (!data)
+		{
+			w->failed = true;
+			return;
+		}
+		w->data = data;
+		w->capacity = capacity;
+	}
+	memcpy(w->data + w->size, src, count);
+	w->size += count;
+}
+static void SerialWriter_PutU32(SerialWriter *w, unsigned int value)
+{
+	unsigned char b[4] = {(unsigned char)value, (unsigned char)(value >> 8),
+	                      (unsigned char)(value >> 16),
+	                      (unsigned char)(value >> 24)};
+	SerialWriter_Put(w, b, 4);
+}
+static void SerialWriter_PutVarint(SerialWriter *w, unsigned long long value)
+{
+	unsigned char b[10];
+	int count = 0;
+	do
+	{
+		b[count] = (unsigned char)(value & 0x7F);
+		value >>= 7;
+		if (value)
+			b[count] |= 0x80;
+		count++;
+	} while (value);
+	SerialWriter_Put(w, b, count);
+}
+static void SerialWriter_PutKey(SerialWriter *w, int id, SerialType type)
+{
+	SerialWriter_PutVarint(w, ((unsigned long long)id << 2) | type);
+}
+void SerialWriter_Begin(SerialWriter *w, const char *magic, int version)
+{
+	memset(w, 0, sizeof(SerialWriter));
+	SerialWriter_Put(w, magic, 4);
+	SerialWriter_PutU32(w, (unsigned int)version);
+}
+void SerialWriter_Free(SerialWriter *w)
+{
+	Mem_Free(w->data);
+	memset(w, 0, sizeof(SerialWriter));
+}
+// Zigzag keeps small negative numbers (like -1 for "none") to one byte.
+void SerialWriter_PutInt(SerialWriter *w, int id, long long value)
+{
+	SerialWriter_PutKey(w, id, SERIAL_INT);
+	SerialWriter_PutVarint(w, ((unsigned long long)value << 1) ^
+	                              (value < 0 ? ~0ull : 0ull));
+}
+void SerialWriter_PutFloat(SerialWriter *w, int id, float value)
+{
+	unsigned int bits;
+	memcpy(&bits, &value, sizeof(bits));
+	SerialWriter_PutKey(w, id, SERIAL_FLOAT);
+	SerialWriter_PutU32(w, bits);
+}
+void SerialWriter_PutBytes(SerialWriter *w, int id, const void *data,
+                           int size)
+{
+	SerialWriter_PutKey(w, id, SERIAL_BYTES);
+	SerialWriter_PutVarint(w, (unsigned long long)size);
+	SerialWriter_Put(w, data, size);
+}
+void SerialWriter_PutString(SerialWriter *w, int id, const char *text)
+{
+	SerialWriter_PutBytes(w, id, text, (int)strlen(text));
+}
+// Returns a mark for SerialWriter_EndSection, which patches in the length
+// once the nested fields are written.
+int SerialWriter_BeginSection(SerialWriter *w, int id)
+{
+	SerialWriter_PutKey(w, id, SERIAL_SECTION);
+	SerialWriter_PutU32(w, 0);
+	return w->size;
+}
+void SerialWriter_EndSection(SerialWriter *w, int section)
+{
+	if (w->failed)
+		return;
+	unsigned int length = (unsigned int)(w->size - section);
+	w->data[section - 4] = (unsigned char)length;
+	w->data[section - 3] = (unsigned char)(length >> 8);
+	w->data[section - 2] = (unsigned char)(length >> 16);
+	w->data[section - 1] = (unsigned char)(length >> 24);
+}
+
+static bool SerialReader_GetVarint(SerialReader *r, unsigned long long *value)
+{
+	*value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		if (r->pos >= r->size)
+			return false;
+		unsigned char b = r->data[r->pos++];
+		*value |= (unsigned long long)(b & 0x7F) << shift;
+		if (!(b & 0x80))
+			return true;
+	}
+	return false;
+}
+static bool SerialReader_GetU32(SerialReader *r, unsigned int *value)
+{
+	if (r->size - r->pos < 4)
+		return false;
+	const unsigned char *p = r->data + r->pos;
+	*value = (unsigned int)p[0] | ((unsigned int)p[1] << 8) |
+	         ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+	r->pos += 4;
+	return true;
+}
+// False if the data is not this kind of file; *version is the schema the
+// file was written with, for readers that need to reinterpret old fields.
+bool SerialReader_Open(SerialReader *r, const unsigned char *data, int size,
+                       const char *magic, int *version)
+{
+	r->data = data;
+	r->size = size;
+	r->pos = 0;
+	unsigned int value = 0;
+	if (size < 8 || memcmp(data, magic, 4) != 0)
+		return false;
+	r->pos = 4;
+	SerialReader_GetU32(r, &value);
+	if (version)
+		*version = (int)value;
+	return true;
+}
+void SerialReader_OpenSection(SerialReader *r, const SerialField *section)
+{
+	r->data = section->data;
+	r->size = section->type == SERIAL_SECTION ? section->size : 0;
+	r->pos = 0;
+}
+// Reads the next field and steps over its payload. Stops at the end of the
+// data or at anything truncated or malformed; fields read before that stay
+// valid, so a damaged tail loses only what it held.
+bool SerialReader_Next(SerialReader *r, SerialField *field)
+{
+	unsigned long long key;
+	unsigned long long value;
+	unsigned int bits;
+	memset(field, 0, sizeof(SerialField));
+	if (r->pos >= r->size || !SerialReader_GetVarint(r, &key))
+		return false;
+	field->id = (int)(key >> 2);
+	field->type = (SerialType)(key & 3);
+	switch (field->type)
+	{
+	case SERIAL_INT:
+		if (!SerialReader_GetVarint(r, &value))
+			return false;
+		field->intValue = (long long)(value >> 1) ^ -(long long)(value & 1);
+		field->floatValue = (float)field->intValue;
+		return true;
+	case SERIAL_FLOAT:
+		if (!SerialReader_GetU32(r, &bits))
+			return false;
+		memcpy(&field->floatValue, &bits, sizeof(float));
+		field->intValue = (long long)field->floatValue;
+		return true;
+	case SERIAL_BYTES:
+		if (!SerialReader_GetVarint(r, &value))
+			return false;
+		break;
+	case SERIAL_SECTION:
+		if (!SerialReader_GetU32(r, &bits))
+			return false;
+		value = bits;
+		break;
+	}
+	if (value > (unsigned long long)(r->size - r->pos))
+		return false;
+	field->data = r->data + r->pos;
+	field->size = (int)value;
+	r->pos += (int)value;
+	return true;
+}
+int Serial_GetInt(const SerialField *field) { return (int)field->intValue; }
+float Serial_GetFloat(const SerialField *field) { return field->floatValue; }
+// Truncates to fit; non-byte fields read as an empty string.
+void Serial_GetString(const SerialField *field, char *text, int size)
+{
+	int length = field->type == SERIAL_BYTES ? field->size : 0;
+	if (length > size - 1)
+		length = size - 1;
+	if (length > 0)
+		memcpy(text, field->data, length);
+	text[length] = '\0';
+}
+// Plain stdio rather than LoadFileData: these files live next to the game,
+// never in the asset pack. Free the result with Mem_Free().
+unsigned char *Serial_ReadFile(const char *path, int *size)
+{
+	*size = 0;
+	FILE *f = fopen(path, "rb");
+	if (!f)
+		return NULL;
+	unsigned char *data = NULL;
+	long length = -1;
+	if (fseek(f, 0, SEEK_END) == 0)
+		length = ftell(f);
+	if (length >= 0 && fseek(f, 0, SEEK_SET) == 0)
+		data = (unsigned char *)Mem_Alloc(MEM_TAG_SAVES,
+		                                  length > 0 ? length : 1);
+	if (data && fread(data, 1, length, f) != (size_t)length)
+	{
+		Mem_Free(data);
+		data = NULL;
+	}
+	fclose(f);
+	if (data)
+		*size = (int)length;
+	return data;
+}
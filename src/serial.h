@@ -0,0 +1,66 @@
+#ifndef SERIAL_H
+#define SERIAL_H
+#include <stdbool.h>
+// Tagged binary encoding shared by saves, settings and achievements. A
+// file is a 4-byte magic and a u32 schema version, then a list of fields.
+// Each field is a varint key (id << 2 | type) followed by its payload:
+//   SERIAL_INT      zigzag varint
+//   SERIAL_FLOAT    4 bytes, little-endian IEEE 754
+//   SERIAL_BYTES    varint length, then the bytes (strings, blobs)
+//   SERIAL_SECTION  u32 length, then nested fields
+// Readers skip ids they do not know and fields missing from older files
+// keep whatever default the caller set, so a schema can gain and lose
+// fields without breaking files written by either side.
+typedef enum
+{
+	SERIAL_INT,
+	SERIAL_FLOAT,
+	SERIAL_BYTES,
+	SERIAL_SECTION
+} SerialType;
+
+typedef struct
+{
+	unsigned char *data;
+	int size;
+	int capacity;
+	bool failed;
+} SerialWriter;
+
+typedef struct
+{
+	const unsigned char *data;
+	int size;
+	int pos;
+} SerialReader;
+
+typedef struct
+{
+	int id;
+	SerialType type;
+	long long intValue;
+	float floatValue;
+	const unsigned char *data; // SERIAL_BYTES and SERIAL_SECTION payload
+	int size;
+} SerialField;
+
+void SerialWriter_Begin(SerialWriter *w, const char *magic, int version);
+void SerialWriter_Free(SerialWriter *w);
+void SerialWriter_PutInt(SerialWriter *w, int id, long long value);
+void SerialWriter_PutFloat(SerialWriter *w, int id, float value);
+void SerialWriter_PutBytes(SerialWriter *w, int id, const void *data,
+                           int size);
+void SerialWriter_PutString(SerialWriter *w, int id, const char *text);
+int SerialWriter_BeginSection(SerialWriter *w, int id);
+void SerialWriter_EndSection(SerialWriter *w, int section);
+bool SerialReader_Open(SerialReader *r, const unsigned char *data, int size,
+                       const char *magic, int *version);
+void SerialReader_OpenSection(SerialReader *r, const SerialField *section);
+bool SerialReader_Next(SerialReader *r, SerialField *field);
+// Numeric getters convert between SERIAL_INT and SERIAL_FLOAT, so a field
+// can change between the two.
+int Serial_GetInt(const SerialField *field);
+float Serial_GetFloat(const SerialField *field);
+void Serial_GetString(const SerialField *field, char *text, int size);
+unsigned char *Serial_ReadFile(const char *path, int *size);
+#endif
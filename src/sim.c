@@ -0,0 +1,250 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sim.h"
+#include "memtrack.h"
+#include <string.h>
+
+#define SIM_FNV_OFFSET 14695981039346656037ull
+#define SIM_FNV_PRIME 1099511628211ull
+
+Sim *Sim_Create(const Level *level)
+{
+	Sim *sim = (Sim *)Mem_Calloc(MEM_TAG_OTHER, 1, sizeof(Sim));
+	if (!sim)
+		return NULL;
+	sim->world.level = *level;
+	World_Populate(&sim->world);
+	sim->status = SIM_RUNNING;
+	return sim;
+}
+void Sim_Destroy(Sim *sim) { Mem_Free(sim); }
+// The same sequence as the STATE_PLAYING branch of Game_Update.
+SimStatus Sim_Step(Sim *sim, unsigned int input)
+{
+	if (sim->status != SIM_RUNNING)
+		return sim->status;
+	World *world = &sim->world;
+	unsigned int pressed = input & ~sim->lastInput;
+	sim->lastInput = input;
+	if ((pressed & SIM_INPUT_HEAL) &&
+	    sim->healthPoints >= HEALTH_POINTS_PER_HEAL &&
+	    world->player.health < world->player.maxHealth)
+	{
+		sim->healthPoints = 0;
+		Player_Heal(&world->player, 1);
+	}
+	PlayerInput playerInput = {
+	    .left = (input & SIM_INPUT_LEFT) != 0,
+	    .right = (input & SIM_INPUT_RIGHT) != 0,
+	    .up = (input & (SIM_INPUT_UP | SIM_INPUT_JUMP)) != 0,
+	    .down = (input & SIM_INPUT_DOWN) != 0,
+	    .jumpPressed = (pressed & SIM_INPUT_JUMP) != 0,
+	    .dashPressed = (pressed & SIM_INPUT_DASH) != 0,
+	    .floatPressed = (pressed & SIM_INPUT_FLOAT) != 0,
+	    .spellcardPressed = (pressed & SIM_INPUT_SPELLCARD) != 0,
+	    .cling = (input & SIM_INPUT_CLING) != 0,
+	    .slowDown = (input & SIM_INPUT_SLOW) != 0};
+	World_Update(world, 1.0f / TARGET_FPS, &playerInput);
+	sim->tick++;
+
+	int healthCollected = 0;
+	int scoreCollected = 0;
+	World_CollectItems(world, &healthCollected, &scoreCollected);
+	// Health points past a full heal turn into score.
+	sim->healthPoints += healthCollected;
+	if (sim->healthPoints > HEALTH_POINTS_PER_HEAL)
+	{
+		scoreCollected += (sim->healthPoints - HEALTH_POINTS_PER_HEAL) *
+		                  HEALTH_POINT_TO_SCORE_MULTIPLIER;
+		sim->healthPoints = HEALTH_POINTS_PER_HEAL;
+	}
+	sim->score += scoreCollected;
+
+	// Falling out of the level zeroes health inside World_Update.
+	if (!Player_IsAlive(&world->player))
+	{
+		sim->score = 0;
+		sim->healthPoints = 0;
+		sim->status = SIM_DEAD;
+	}
+	else if (World_LevelCompleted(world))
+	{
+		sim->status = SIM_COMPLETED;
+	}
+	return sim->status;
+}
+void Sim_Respawn(Sim *sim)
+{
+	if (sim->status != SIM_DEAD)
+		return;
+	World_ResetBullets(&sim->world);
+	Player_Init(&sim->world.player, sim->world.player.lastCheckpoint);
+	sim->status = SIM_RUNNING;
+}
+// Dead slots past each count are never read, so they are left alone. The
+// level is normally shared and only copied when dst was made from another.
+void Sim_Clone(Sim *dst, const Sim *src)
+{
+	if (dst == src)
+		return;
+	const World *from = &src->world;
+	World *to = &dst->world;
+	if (to->level.tiles != from->level.tiles)
+		to->level = from->level;
+	to->player = from->player;
+	to->camera = from->camera;
+	to->spawnerCount = from->spawnerCount;
+	memcpy(to->spawners, from->spawners,
+	       from->spawnerCount * sizeof(BulletSpawner));
+	to->bulletCount = from->bulletCount;
+	memcpy(to->bullets, from->bullets, from->bulletCount * sizeof(Bullet));
+	to->collectibleCount = from->collectibleCount;
+	memcpy(to->collectibles, from->collectibles,
+	       from->collectibleCount * sizeof(Collectible));
+	to->parryEffectCount = from->parryEffectCount;
+	memcpy(to->parryEffects, from->parryEffects,
+	       from->parryEffectCount * sizeof(ParryEffect));
+	to->rng = from->rng;
+	dst->tick = src->tick;
+	dst->lastInput = src->lastInput;
+	dst->healthPoints = src->healthPoints;
+	dst->score = src->score;
+	dst->status = src->status;
+}
+
+static uint64_t Sim_HashBytes(uint64_t hash, const void *data, size_t size)
+{
+	const unsigned char *bytes = (const unsigned char *)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= SIM_FNV_PRIME;
+	}
+	return hash;
+}
+#define SIM_HASH(hash, field) Sim_HashBytes(hash, &(field), sizeof(field))
+// Vector2 is two floats and Color four bytes, neither padded, so both hash
+// whole.
+static uint64_t Sim_HashPlayer(uint64_t h, const Player *p)
+{
+	h = SIM_HASH(h, p->position);
+	h = SIM_HASH(h, p->velocity);
+	h = SIM_HASH(h, p->onGround);
+	h = SIM_HASH(h, p->health);
+	h = SIM_HASH(h, p->maxHealth);
+	h = SIM_HASH(h, p->dashCooldown);
+	h = SIM_HASH(h, p->dashTimer);
+	h = SIM_HASH(h, p->isFloating);
+	h = SIM_HASH(h, p->floatTimer);
+	h = SIM_HASH(h, p->floatCooldown);
+	h = SIM_HASH(h, p->canDash);
+	h = SIM_HASH(h, p->invulnerabilityTimer);
+	h = SIM_HASH(h, p->lastCheckpoint);
+	h = SIM_HASH(h, p->coyoteTime);
+	h = SIM_HASH(h, p->jumpBufferTime);
+	h = SIM_HASH(h, p->onWall);
+	h = SIM_HASH(h, p->wallDirection);
+	h = SIM_HASH(h, p->wallJumpTime);
+	h = SIM_HASH(h, p->isClinging);
+	h = SIM_HASH(h, p->clingTimer);
+	h = SIM_HASH(h, p->damageTimer);
+	h = SIM_HASH(h, p->lastTileStanding);
+	h = SIM_HASH(h, p->animState);
+	h = SIM_HASH(h, p->animFrame);
+	h = SIM_HASH(h, p->animTimer);
+	h = SIM_HASH(h, p->facingRight);
+	h = SIM_HASH(h, p->isSlowingDown);
+	h = SIM_HASH(h, p->isDucking);
+	h = SIM_HASH(h, p->canSpellCard);
+	h = SIM_HASH(h, p->spellCard.active);
+	h = SIM_HASH(h, p->spellCard.timer);
+	h = SIM_HASH(h, p->spellCard.radius);
+	h = SIM_HASH(h, p->parryWindowTimer);
+	h = SIM_HASH(h, p->parryCooldown);
+	h = SIM_HASH(h, p->isParryActive);
+	return h;
+}
+// Every field a step reads or writes is hashed; only hasSprite, which is
+// fixed at Player_Init and read by Player_Draw alone, is left out.
+uint64_t Sim_Hash(const Sim *sim)
+{
+	const World *world = &sim->world;
+	uint64_t h = SIM_FNV_OFFSET;
+	h = SIM_HASH(h, sim->tick);
+	h = SIM_HASH(h, sim->lastInput);
+	h = SIM_HASH(h, sim->healthPoints);
+	h = SIM_HASH(h, sim->score);
+	h = SIM_HASH(h, sim->status);
+	h = SIM_HASH(h, world->rng);
+	h = Sim_HashPlayer(h, &world->player);
+	h = SIM_HASH(h, world->camera.target);
+	h = SIM_HASH(h, world->spawnerCount);
+	for (int i = 0; i < world->spawnerCount; i++)
+	{
+		const BulletSpawner *s = &world->spawners[i];
+		h = SIM_HASH(h, s->position);
+		h = SIM_HASH(h, s->pattern);
+		h = SIM_HASH(h, s->cooldown);
+		h = SIM_HASH(h, s->timer);
+		h = SIM_HASH(h, s->active);
+		h = SIM_HASH(h, s->bulletCount);
+		h = SIM_HASH(h, s->bulletSpeed);
+		h = SIM_HASH(h, s->angleOffset);
+		h = SIM_HASH(h, s->spreadAngle);
+		h = SIM_HASH(h, s->rotationSpeed);
+		h = SIM_HASH(h, s->randomizeSpeed);
+		h = SIM_HASH(h, s->speedVariation);
+		h = SIM_HASH(h, s->bulletColor);
+		h = SIM_HASH(h, s->bulletSize);
+		h = SIM_HASH(h, s->health);
+		h = SIM_HASH(h, s->rng);
+	}
+	h = SIM_HASH(h, world->bulletCount);
+	for (int i = 0; i < world->bulletCount; i++)
+	{
+		const Bullet *b = &world->bullets[i];
+		h = SIM_HASH(h, b->position);
+		h = SIM_HASH(h, b->velocity);
+		h = SIM_HASH(h, b->radius);
+		h = SIM_HASH(h, b->active);
+		h = SIM_HASH(h, b->isParried);
+		h = SIM_HASH(h, b->color);
+	}
+	h = SIM_HASH(h, world->collectibleCount);
+	for (int i = 0; i < world->collectibleCount; i++)
+	{
+		const Collectible *c = &world->collectibles[i];
+		h = SIM_HASH(h, c->position);
+		h = SIM_HASH(h, c->velocity);
+		h = SIM_HASH(h, c->radius);
+		h = SIM_HASH(h, c->type);
+		h = SIM_HASH(h, c->active);
+		h = SIM_HASH(h, c->lifetime);
+	}
+	h = SIM_HASH(h, world->parryEffectCount);
+	for (int i = 0; i < world->parryEffectCount; i++)
+	{
+		const ParryEffect *e = &world->parryEffects[i];
+		h = SIM_HASH(h, e->position);
+		h = SIM_HASH(h, e->lifetime);
+		h = SIM_HASH(h, e->radius);
+		h = SIM_HASH(h, e->active);
+	}
+	return h;
+}
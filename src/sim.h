@@ -0,0 +1,57 @@
+#ifndef SIM_H
+#define SIM_H
+#include "world.h"
+#include <stdint.h>
+// The game rules without a window, for search, training and replay tools.
+// "make sim" builds libcirnosim.a from these sources with -DCIRNO_HEADLESS,
+// which needs no raylib library, window or audio device; raylib.h is only
+// read for its types. One Sim_Step is one tick of STATE_PLAYING at
+// TARGET_FPS. Stepping is deterministic within a build: the same level,
+// state and inputs give the same Sim_Hash. A Sim belongs to one thread at
+// a time; separate Sims may step on separate threads.
+typedef enum
+{
+	SIM_INPUT_LEFT = 1 << 0,
+	SIM_INPUT_RIGHT = 1 << 1,
+	SIM_INPUT_UP = 1 << 2,
+	SIM_INPUT_DOWN = 1 << 3,
+	SIM_INPUT_JUMP = 1 << 4,
+	SIM_INPUT_DASH = 1 << 5,
+	SIM_INPUT_FLOAT = 1 << 6,
+	SIM_INPUT_SPELLCARD = 1 << 7,
+	SIM_INPUT_CLING = 1 << 8,
+	SIM_INPUT_SLOW = 1 << 9,
+	SIM_INPUT_HEAL = 1 << 10
+} SimInput;
+typedef enum
+{
+	SIM_RUNNING,
+	SIM_DEAD,
+	SIM_COMPLETED
+} SimStatus;
+typedef struct
+{
+	World world;
+	int tick;
+	unsigned int lastInput; // for telling presses from holds
+	int healthPoints;       // towards the next heal, as in the game
+	int score;              // this attempt's level score
+	SimStatus status;
+} Sim;
+// Starts a Sim at the level's spawn. The tile grid is shared, not copied,
+// so the level must outlive every Sim made from it and its clones.
+Sim *Sim_Create(const Level *level);
+void Sim_Destroy(Sim *sim);
+// Advances one tick with the SimInput bits held this tick. Presses are
+// bits that were not held on the previous step. Once the player dies or
+// reaches the goal the Sim stops and keeps returning that status.
+SimStatus Sim_Step(Sim *sim, unsigned int input);
+// Continues a dead Sim from the last checkpoint, as the death screen does.
+void Sim_Respawn(Sim *sim);
+// Makes dst a copy of src without allocating; dst must come from
+// Sim_Create. Only live bullets, collectibles and effects are copied.
+void Sim_Clone(Sim *dst, const Sim *src);
+// 64-bit FNV-1a over the gameplay state, field by field so struct padding
+// never leaks in. Sims on one level with equal hashes step alike from there.
+uint64_t Sim_Hash(const Sim *sim);
+#endif
@@ -17,6 +17,9 @@
  */
 
 #include "spawner.h"
+#include "atlas.h"
+#include "counters.h"
+#include "renderqueue.h"
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -91,6 +94,39 @@ SpawnerConfig Spawner_GetDefaultConfig(SpawnerPattern pattern)
 	}
 	return config;
 }
+// xorshift32; the state must never be zero.
+unsigned int Spawner_Random(unsigned int *state)
+{
+	unsigned int x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+// Uniform in [0, 1).
+float Spawner_RandomFloat(unsigned int *state)
+{
+	return (Spawner_Random(state) >> 8) * (1.0f / 16777216.0f);
+}
+// Spawners in different places get different streams.
+unsigned int Spawner_SeedFor(Vector2 position)
+{
+	unsigned int seed = (unsigned int)(int)position.x * 73856093u ^
+	                    (unsigned int)(int)position.y * 19349663u;
+	return seed ? seed : 1u;
+}
+static float Spawner_RandomSpeed(BulletSpawner *spawner)
+{
+	int range = (int)(spawner->speedVariation * 2);
+	return (float)(Spawner_Random(&spawner->rng) % range) -
+	       spawner->speedVariation;
+}
+static unsigned char Spawner_Jitter(unsigned char value, unsigned int *rng)
+{
+	int jittered = value + (int)(Spawner_Random(rng) % 50) - 25;
+	return (unsigned char)(jittered < 0 ? 0 : jittered > 255 ? 255 : jittered);
+}
 void Spawner_Init(BulletSpawner *spawner, Vector2 position,
                   SpawnerPattern pattern)
 {
@@ -115,6 +151,7 @@ void Spawner_InitWithConfig(BulletSpawner *spawner, Vector2 position,
 	spawner->bulletColor = config.bulletColor;
 	spawner->bulletSize = config.bulletSize;
 	spawner->health = SPAWNER_INITIAL_HEALTH;
+	spawner->rng = Spawner_SeedFor(position);
 }
 void Spawner_Update(BulletSpawner *spawner, Bullet bullets[], int *bulletCount,
                     Collectible collectibles[], int *collectibleCount,
@@ -135,6 +172,7 @@ void Spawner_Update(BulletSpawner *spawner, Bullet bullets[], int *bulletCount,
 	if (spawner->timer >= spawner->cooldown)
 	{
 		spawner->timer = 0;
+		int before = *bulletCount;
 		switch (spawner->pattern)
 		{
 		case SPAWNER_PATTERN_CIRCLE:
@@ -153,43 +191,54 @@ void Spawner_Update(BulletSpawner *spawner, Bullet bullets[], int *bulletCount,
 			Spawner_PatternTargeting(spawner, bullets, bulletCount, playerPos);
 			break;
 		}
+		// Every pattern fires spawner->bulletCount unless the pool is full.
+		int spawned = *bulletCount - before;
+		Counters_Add(COUNTER_BULLETS_SPAWNED, spawned);
+		Counters_Add(COUNTER_BULLETS_TRUNCATED, spawner->bulletCount - spawned);
 		
 		// Randomly spawn collectibles
 		if (*collectibleCount < MAX_COLLECTIBLES - 5)
 		{
-			float spawnRoll = (float)rand() / RAND_MAX;
+			float spawnRoll = Spawner_RandomFloat(&spawner->rng);
 			if (spawnRoll < COLLECTIBLE_SPAWN_CHANCE)
 			{
-				float typeRoll = (float)rand() / RAND_MAX;
+				float typeRoll = Spawner_RandomFloat(&spawner->rng);
 				CollectibleType type = (typeRoll < HEALTH_POINT_SPAWN_WEIGHT) 
 				                       ? COLLECTIBLE_HEALTH_POINT 
 				                       : COLLECTIBLE_SCORE;
 				Vector2 center = Vector2Add(spawner->position, (Vector2){25, 25});
-				Collectible_Spawn(collectibles, collectibleCount, center, type);
+				Collectible_Spawn(collectibles, collectibleCount, center, type,
+				                  &spawner->rng);
 			}
 		}
+		// The last few slots are kept for other drops; a roll that would
+		// have spawned into them still counts as dropped.
+		else if (Spawner_RandomFloat(&spawner->rng) < COLLECTIBLE_SPAWN_CHANCE)
+			Counters_Add(COUNTER_COLLECTIBLES_DROPPED, 1);
 	}
 }
+#ifndef CIRNO_HEADLESS
 void Spawner_Draw(const BulletSpawner *spawner)
 {
 	if (!spawner->active)
 		return;
 	Vector2 center = Vector2Add(spawner->position, (Vector2){25, 25});
-	DrawCircleV(center, 20, spawner->bulletColor);
-	DrawCircleV(center, 18, BLACK);
-	DrawCircleV(center, 15, spawner->bulletColor);
+	RenderQueue_SetLayer(RENDER_LAYER_SPAWNERS);
+	RenderQueue_CircleV(center, 20, spawner->bulletColor);
+	RenderQueue_CircleV(center, 18, BLACK);
+	RenderQueue_CircleV(center, 15, spawner->bulletColor);
 	float progress = 1.0f - (spawner->timer / spawner->cooldown);
 	if (progress < 1.0f)
 	{
-		DrawRing(center, 22, 25, 0, progress * 360, 36,
-		         (Color){255, 255, 255, 200});
+		RenderQueue_Ring(center, 22, 25, 0, progress * 360, 36,
+		                 (Color){255, 255, 255, 200});
 	}
 	if (spawner->pattern == SPAWNER_PATTERN_SPIRAL)
 	{
 		float angle = spawner->angleOffset * DEG2RAD;
 		Vector2 indicator = {center.x + cosf(angle) * 18,
 		                     center.y + sinf(angle) * 18};
-		DrawLineEx(center, indicator, 3, WHITE);
+		RenderQueue_LineEx(center, indicator, 3, WHITE);
 	}
 	
 	// Draw health bar above spawner
@@ -202,15 +251,18 @@ void Spawner_Draw(const BulletSpawner *spawner)
 		Vector2 barPos = {center.x - barWidth / 2, center.y - 35};
 		
 		// Background
-		DrawRectangle((int)barPos.x, (int)barPos.y, (int)barWidth, (int)barHeight, DARKGRAY);
+		RenderQueue_Rectangle((int)barPos.x, (int)barPos.y, (int)barWidth,
+		                      (int)barHeight, DARKGRAY);
 		
 		// Health bar (green to red gradient based on health)
 		Color healthColor = (healthPercent > 0.5f) ? GREEN : 
 		                   (healthPercent > 0.25f) ? ORANGE : RED;
-		DrawRectangle((int)barPos.x, (int)barPos.y, 
-		             (int)(barWidth * healthPercent), (int)barHeight, healthColor);
+		RenderQueue_Rectangle((int)barPos.x, (int)barPos.y,
+		                      (int)(barWidth * healthPercent), (int)barHeight,
+		                      healthColor);
 	}
 }
+#endif
 void Spawner_PatternCircle(BulletSpawner *spawner, Bullet bullets[],
                            int *bulletCount)
 {
@@ -220,11 +272,10 @@ void Spawner_PatternCircle(BulletSpawner *spawner, Bullet bullets[],
 	{
 		float angle = (angleStep * i + spawner->angleOffset) * DEG2RAD;
 		float speed = spawner->bulletSpeed;
-		if (spawner->randomizeSpeed)
-		{
-			speed += (rand() % (int)(spawner->speedVariation * 2)) -
-			         spawner->speedVariation;
-		}
+		// Under one unit of variation there is nothing to randomize, and
+		// the modulo in Spawner_RandomSpeed would divide by zero.
+		if (spawner->randomizeSpeed && spawner->speedVariation >= 1.0f)
+			speed += Spawner_RandomSpeed(spawner);
 		Vector2 velocity = {cosf(angle) * speed, sinf(angle) * speed};
 		bullets[*bulletCount] = (Bullet){.position = center,
 		                                 .velocity = velocity,
@@ -285,19 +336,16 @@ void Spawner_PatternBurst(BulletSpawner *spawner, Bullet bullets[],
 	{
 		float angle = (angleStep * i + spawner->angleOffset) * DEG2RAD;
 		float speed = spawner->bulletSpeed;
-		if (spawner->randomizeSpeed)
-		{
-			speed += (rand() % (int)(spawner->speedVariation * 2)) -
-			         spawner->speedVariation;
-		}
+		if (spawner->randomizeSpeed && spawner->speedVariation >= 1.0f)
+			speed += Spawner_RandomSpeed(spawner);
 		Vector2 velocity = {cosf(angle) * speed, sinf(angle) * speed};
 		// Add some color variation for burst pattern
 		Color bulletColor = spawner->bulletColor;
 		if (spawner->randomizeSpeed) {
 			// Slightly vary the color for burst pattern
-			bulletColor.r = (unsigned char)((bulletColor.r + (rand() % 50) - 25) > 255 ? 255 : (bulletColor.r + (rand() % 50) - 25) < 0 ? 0 : bulletColor.r + (rand() % 50) - 25);
-			bulletColor.g = (unsigned char)((bulletColor.g + (rand() % 50) - 25) > 255 ? 255 : (bulletColor.g + (rand() % 50) - 25) < 0 ? 0 : bulletColor.g + (rand() % 50) - 25);
-			bulletColor.b = (unsigned char)((bulletColor.b + (rand() % 50) - 25) > 255 ? 255 : (bulletColor.b + (rand() % 50) - 25) < 0 ? 0 : bulletColor.b + (rand() % 50) - 25);
+			bulletColor.r = Spawner_Jitter(bulletColor.r, &spawner->rng);
+			bulletColor.g = Spawner_Jitter(bulletColor.g, &spawner->rng);
+			bulletColor.b = Spawner_Jitter(bulletColor.b, &spawner->rng);
 		}
 		bullets[*bulletCount] = (Bullet){.position = center,
 		                                 .velocity = velocity,
@@ -390,13 +438,27 @@ void Bullet_Update(Bullet bullets[], int *bulletCount, Player *player, float dt)
 			writeIndex++;
 		}
 	}
+	Counters_Add(COUNTER_BULLETS_DESPAWNED, *bulletCount - writeIndex);
 	*bulletCount = writeIndex;
 }
+#ifndef CIRNO_HEADLESS
+// Bullets are one white disc from the atlas tinted three times, which keeps
+// thousands of them in a single batch.
+static void Bullet_DrawDisc(Texture2D atlas, Rectangle disc, Vector2 center,
+                            float radius, Color color)
+{
+	Rectangle dst = {center.x - radius, center.y - radius, radius * 2,
+	                 radius * 2};
+	RenderQueue_Quad(atlas, disc, dst, color);
+}
 void Bullet_Draw(const Bullet bullets[], int bulletCount)
 {
 	// Early exit if no bullets
 	if (bulletCount == 0)
 		return;
+	Texture2D atlas = Atlas_GetTexture();
+	Rectangle disc = Atlas_GetSprite(ATLAS_SPRITE_BULLET);
+	RenderQueue_SetLayer(RENDER_LAYER_BULLETS);
 	for (int i = 0; i < bulletCount; i++)
 	{
 		if (!bullets[i].active)
@@ -406,28 +468,32 @@ void Bullet_Draw(const Bullet bullets[], int bulletCount)
 		if (bullets[i].isParried)
 		{
 			// Cyan/blue color for parried bullets
-			DrawCircleV(bullets[i].position, bullets[i].radius + 2,
-			            (Color){100, 200, 255, 100});
-			DrawCircleV(bullets[i].position, bullets[i].radius, (Color){50, 150, 255, 255});
-			DrawCircleV(bullets[i].position, bullets[i].radius - 1,
-			            (Color){150, 220, 255, 255});
+			Bullet_DrawDisc(atlas, disc, bullets[i].position,
+			                bullets[i].radius + 2, (Color){100, 200, 255, 100});
+			Bullet_DrawDisc(atlas, disc, bullets[i].position,
+			                bullets[i].radius, (Color){50, 150, 255, 255});
+			Bullet_DrawDisc(atlas, disc, bullets[i].position,
+			                bullets[i].radius - 1, (Color){150, 220, 255, 255});
 		}
 		else
 		{
 			// Use bullet's own color
-			DrawCircleV(bullets[i].position, bullets[i].radius + 2,
-			            (Color){255, 255, 255, 50});
-			DrawCircleV(bullets[i].position, bullets[i].radius, bullets[i].color);
+			Bullet_DrawDisc(atlas, disc, bullets[i].position,
+			                bullets[i].radius + 2, (Color){255, 255, 255, 50});
+			Bullet_DrawDisc(atlas, disc, bullets[i].position,
+			                bullets[i].radius, bullets[i].color);
 			
 			// Add a slightly lighter center for visual effect
 			Color lightColor = bullets[i].color;
 			lightColor.r = (unsigned char)(lightColor.r + (255 - lightColor.r) * 0.4f);
 			lightColor.g = (unsigned char)(lightColor.g + (255 - lightColor.g) * 0.4f);
 			lightColor.b = (unsigned char)(lightColor.b + (255 - lightColor.b) * 0.4f);
-			DrawCircleV(bullets[i].position, bullets[i].radius - 1, lightColor);
+			Bullet_DrawDisc(atlas, disc, bullets[i].position,
+			                bullets[i].radius - 1, lightColor);
 		}
 	}
 }
+#endif
 bool Bullet_CheckCollision(const Bullet *bullet, Rectangle playerBounds)
 {
 	if (!bullet->active)
@@ -446,13 +512,18 @@ bool Bullet_CheckCollision(const Bullet *bullet, Rectangle playerBounds)
 
 // Collectible system implementation
 void Collectible_Spawn(Collectible collectibles[], int *collectibleCount,
-                       Vector2 position, CollectibleType type)
+                       Vector2 position, CollectibleType type,
+                       unsigned int *rng)
 {
 	if (*collectibleCount >= MAX_COLLECTIBLES)
+	{
+		Counters_Add(COUNTER_COLLECTIBLES_DROPPED, 1);
 		return;
+	}
+	Counters_Add(COUNTER_COLLECTIBLES_SPAWNED, 1);
 	
 	// Random direction
-	float angle = ((float)rand() / RAND_MAX) * 360.0f * DEG2RAD;
+	float angle = Spawner_RandomFloat(rng) * 360.0f * DEG2RAD;
 	Vector2 velocity = {
 		cosf(angle) * COLLECTIBLE_SPEED,
 		sinf(angle) * COLLECTIBLE_SPEED
@@ -515,42 +586,31 @@ void Collectible_Update(Collectible collectibles[], int *collectibleCount, float
 	*collectibleCount = writeIndex;
 }
 
+#ifndef CIRNO_HEADLESS
 void Collectible_Draw(const Collectible collectibles[], int collectibleCount)
 {
+	Texture2D atlas = Atlas_GetTexture();
+	Rectangle healthIcon = Atlas_GetSprite(ATLAS_SPRITE_HEALTH_POINT);
+	Rectangle scoreIcon = Atlas_GetSprite(ATLAS_SPRITE_SCORE_ITEM);
+	RenderQueue_SetLayer(RENDER_LAYER_COLLECTIBLES);
 	for (int i = 0; i < collectibleCount; i++)
 	{
 		if (!collectibles[i].active)
 			continue;
 		
-		Color color;
-		if (collectibles[i].type == COLLECTIBLE_HEALTH_POINT)
-		{
-			color = HEALTH_POINT_COLOR;
-			// Draw cross for health
-			DrawCircleV(collectibles[i].position, collectibles[i].radius + 2, 
-			           (Color){255, 255, 255, 100});
-			DrawCircleV(collectibles[i].position, collectibles[i].radius, color);
-			
-			float size = collectibles[i].radius * 0.6f;
-			DrawRectangle(collectibles[i].position.x - size / 4, 
-			             collectibles[i].position.y - size,
-			             size / 2, size * 2, WHITE);
-			DrawRectangle(collectibles[i].position.x - size, 
-			             collectibles[i].position.y - size / 4,
-			             size * 2, size / 2, WHITE);
-		}
-		else // COLLECTIBLE_SCORE
-		{
-			color = SCORE_ITEM_COLOR;
-			// Draw star for score
-			DrawCircleV(collectibles[i].position, collectibles[i].radius + 2, 
-			           (Color){255, 255, 255, 100});
-			DrawCircleV(collectibles[i].position, collectibles[i].radius, color);
-			DrawCircleV(collectibles[i].position, collectibles[i].radius - 2, 
-			           (Color){255, 235, 100, 255});
-		}
+		// Icons are baked with their glow ring, which extends 2px past the
+		// pickup radius.
+		float extent = collectibles[i].radius + 2;
+		Rectangle dst = {collectibles[i].position.x - extent,
+		                 collectibles[i].position.y - extent, extent * 2,
+		                 extent * 2};
+		Rectangle src = collectibles[i].type == COLLECTIBLE_HEALTH_POINT
+		                    ? healthIcon
+		                    : scoreIcon;
+		RenderQueue_Quad(atlas, src, dst, WHITE);
 	}
 }
+#endif
 
 bool Collectible_CheckCollection(const Collectible *collectible, Rectangle playerBounds)
 {
@@ -618,8 +678,10 @@ void ParryEffect_Update(ParryEffect effects[], int *effectCount, float dt)
 	*effectCount = writeIndex;
 }
 
+#ifndef CIRNO_HEADLESS
 void ParryEffect_Draw(const ParryEffect effects[], int effectCount)
 {
+	RenderQueue_SetLayer(RENDER_LAYER_OVERLAY);
 	for (int i = 0; i < effectCount; i++)
 	{
 		if (!effects[i].active)
@@ -631,14 +693,17 @@ void ParryEffect_Draw(const ParryEffect effects[], int effectCount)
 		effectColor.a = (unsigned char)(effectColor.a * alphaFactor);
 		
 		// Draw expanding ring effect
-		DrawCircleV(effects[i].position, effects[i].radius, 
+		RenderQueue_CircleV(effects[i].position, effects[i].radius, 
 		           (Color){effectColor.r, effectColor.g, effectColor.b, (unsigned char)(effectColor.a * 0.3f)});
-		DrawCircleLines((int)effects[i].position.x, (int)effects[i].position.y, 
-		               effects[i].radius, effectColor);
-		DrawCircleLines((int)effects[i].position.x, (int)effects[i].position.y, 
-		               effects[i].radius - 2, effectColor);
+		RenderQueue_CircleLines((int)effects[i].position.x,
+		                        (int)effects[i].position.y, effects[i].radius,
+		                        effectColor);
+		RenderQueue_CircleLines((int)effects[i].position.x,
+		                        (int)effects[i].position.y,
+		                        effects[i].radius - 2, effectColor);
 	}
 }
+#endif
 
 // Spawner damage system
 BulletSpawner* Spawner_FindNearest(BulletSpawner spawners[], int spawnerCount, Vector2 position)
@@ -26,6 +26,12 @@ void Spawner_Update(BulletSpawner *spawner, Bullet bullets[], int *bulletCount,
                     Vector2 playerPos, float dt);
 void Spawner_Draw(const BulletSpawner *spawner);
 
+// Gameplay randomness. Every spawner and every World carries its own
+// state instead of sharing rand(), so a copied World replays exactly.
+unsigned int Spawner_Random(unsigned int *state);
+float Spawner_RandomFloat(unsigned int *state);
+unsigned int Spawner_SeedFor(Vector2 position);
+
 // Bullet functions
 void Bullet_Update(Bullet bullets[], int *bulletCount, Player *player, float dt);
 void Bullet_Draw(const Bullet bullets[], int bulletCount);
@@ -36,7 +42,8 @@ void Collectible_Update(Collectible collectibles[], int *collectibleCount, float
 void Collectible_Draw(const Collectible collectibles[], int collectibleCount);
 bool Collectible_CheckCollection(const Collectible *collectible, Rectangle playerBounds);
 void Collectible_Spawn(Collectible collectibles[], int *collectibleCount,
-                       Vector2 position, CollectibleType type);
+                       Vector2 position, CollectibleType type,
+                       unsigned int *rng);
 
 // Parry effect functions
 void ParryEffect_Spawn(ParryEffect effects[], int *effectCount, Vector2 position);
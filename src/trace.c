@@ -0,0 +1,164 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "trace.h"
+#include "config.h"
+#include "memtrack.h"
+#include "writer.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct
+{
+	const char *name;
+	double time;
+	char phase; // 'B' or 'E'
+	unsigned char thread;
+} TraceEvent;
+
+static TraceEvent events[TRACE_CAPACITY];
+static int eventHead = 0;
+static int eventCount = 0;
+static pthread_t threads[TRACE_MAX_THREADS];
+static int threadCount = 0;
+static double startTime = 0.0;
+static volatile bool recording = false;
+static pthread_mutex_t traceLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Small stable ids for the trace's tid field; the main thread is 0 because
+// Trace_Init runs on it first.
+static int Trace_ThreadIndex(void)
+{
+	pthread_t self = pthread_self();
+	for (int i = 0; i < threadCount; i++)
+	{
+		if (pthread_equal(threads[i], self))
+			return i;
+	}
+	if (threadCount >= TRACE_MAX_THREADS)
+		return TRACE_MAX_THREADS - 1;
+	threads[threadCount] = self;
+	return threadCount++;
+}
+static void Trace_Record(const char *name, char phase)
+{
+	if (!recording)
+		return;
+	double time = GetTime();
+	pthread_mutex_lock(&traceLock);
+	TraceEvent *event = &events[eventHead];
+	event->name = name;
+	event->time = time;
+	event->phase = phase;
+	event->thread = (unsigned char)Trace_ThreadIndex();
+	eventHead = (eventHead + 1) % TRACE_CAPACITY;
+	if (eventCount < TRACE_CAPACITY)
+		eventCount++;
+	pthread_mutex_unlock(&traceLock);
+}
+void Trace_Begin(const char *name) { Trace_Record(name, 'B'); }
+void Trace_End(const char *name) { Trace_Record(name, 'E'); }
+// Appends at size unless the buffer is already full. Past capacity the size
+// stops growing, so it never walks beyond the buffer, but stays >= capacity
+// to tell the caller the output was cut short.
+static int Trace_Append(char *json, int capacity, int size,
+                        const char *format, ...)
+{
+	if (size >= capacity)
+		return size;
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(json + size, capacity - size, format, args);
+	va_end(args);
+	return length < 0 ? capacity : size + length;
+}
+// Formats the ring, oldest first, and hands it to the writer thread. The
+// ring may start partway into a scope; viewers ignore the unmatched end.
+static void Trace_Write(void)
+{
+	pthread_mutex_lock(&traceLock);
+	int capacity = 64 + eventCount * 96 + threadCount * 96;
+	char *json = (char *)Mem_Alloc(MEM_TAG_OTHER, capacity);
+	if (!json)
+	{
+		pthread_mutex_unlock(&traceLock);
+		return;
+	}
+	int size = Trace_Append(json, capacity, 0, "{\"traceEvents\":[\n");
+	for (int i = 0; i < threadCount; i++)
+	{
+		size = Trace_Append(json, capacity, size,
+		                    "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+		                    "\"tid\":%d,\"args\":{\"name\":\"%s %d\"}},\n",
+		                    i, i == 0 ? "Main" : "Worker", i);
+	}
+	for (int i = 0; i < eventCount; i++)
+	{
+		const TraceEvent *event =
+		    &events[(eventHead - eventCount + i + TRACE_CAPACITY) %
+		            TRACE_CAPACITY];
+		size = Trace_Append(json, capacity, size,
+		                    "{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,"
+		                    "\"tid\":%d,\"ts\":%.1f}%s\n",
+		                    event->name, event->phase, event->thread,
+		                    (event->time - startTime) * 1000000.0,
+		                    i + 1 < eventCount ? "," : "");
+	}
+	size = Trace_Append(json, capacity, size, "]}\n");
+	int written = eventCount;
+	eventCount = 0;
+	eventHead = 0;
+	pthread_mutex_unlock(&traceLock);
+	if (size < capacity)
+	{
+		Writer_Submit(TRACE_FILE, json, size);
+		TraceLog(LOG_INFO, "TRACE: %d events written to %s", written,
+		         TRACE_FILE);
+	}
+	else
+	{
+		TraceLog(LOG_WARNING, "TRACE: %d events did not fit, nothing written",
+		         written);
+	}
+	Mem_Free(json);
+}
+void Trace_Init(void)
+{
+	startTime = GetTime();
+	Mem_TrackStatic(MEM_TAG_OTHER, sizeof(events));
+	pthread_mutex_lock(&traceLock);
+	Trace_ThreadIndex();
+	pthread_mutex_unlock(&traceLock);
+	if (getenv("CIRNO_TRACE"))
+		Trace_SetRecording(true);
+}
+void Trace_Shutdown(void) { Trace_SetRecording(false); }
+bool Trace_IsRecording(void) { return recording; }
+// Stopping writes out what was recorded.
+void Trace_SetRecording(bool enabled)
+{
+	if (enabled == recording)
+		return;
+	recording = enabled;
+	if (enabled)
+		TraceLog(LOG_INFO, "TRACE: recording");
+	else
+		Trace_Write();
+}
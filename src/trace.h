@@ -0,0 +1,22 @@
+#ifndef TRACE_H
+#define TRACE_H
+#include <stdbool.h>
+// Begin/end events for a Chrome Trace Event file (chrome://tracing,
+// ui.perfetto.dev). Recording is off until F4 or the CIRNO_TRACE
+// environment variable turns it on; the newest TRACE_CAPACITY events are
+// kept and written to TRACE_FILE when recording stops or the game exits.
+// Names must be string literals, since only the pointer is stored. Safe
+// to call from any thread.
+void Trace_Init(void);
+void Trace_Shutdown(void);
+#ifdef CIRNO_HEADLESS
+// The simulation library has no trace file.
+#define Trace_Begin(name) ((void)0)
+#define Trace_End(name) ((void)0)
+#else
+void Trace_Begin(const char *name);
+void Trace_End(const char *name);
+#endif
+bool Trace_IsRecording(void);
+void Trace_SetRecording(bool recording);
+#endif
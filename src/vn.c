@@ -17,9 +17,26 @@
  */
 
 #include "vn.h"
+#include "cache.h"
 #include "config.h"
+#include "trace.h"
 #include <stdio.h>
 #include <string.h>
+// Portraits come from the shared cache, so a character who shows up in
+// several levels is only decoded once.
+static void VN_AcquireTexture(VNState *vn, const char *path)
+{
+	Trace_Begin("VN texture");
+	vn->characterTexture =
+	    AssetCache_AcquireTexture(path, ASSET_LIFETIME_LEVEL, MEM_TAG_VN);
+	Trace_End("VN texture");
+	if (vn->characterTexture.id != 0)
+	{
+		strncpy(vn->texturePath, path, sizeof(vn->texturePath) - 1);
+		vn->texturePath[sizeof(vn->texturePath) - 1] = '\0';
+		vn->hasTexture = true;
+	}
+}
 void VN_Init(VNState *vn, Level *level)
 {
 	vn->dialogues = level->dialogues;
@@ -29,21 +46,28 @@ void VN_Init(VNState *vn, Level *level)
 	vn->textTimer = 0;
 	vn->isComplete = false;
 	vn->hasTexture = false;
-	if (vn->dialogueCount > 0 && vn->dialogues[0].characterSprite[0] != '\0')
+	// Decode every portrait of the scene in the background now; each one is
+	// picked up in VN_Update once it is ready, so neither starting the scene
+	// nor advancing a line waits on the disk.
+	for (int i = 0; i < vn->dialogueCount; i++)
 	{
-		if (FileExists(vn->dialogues[0].characterSprite))
-		{
-			vn->characterTexture =
-			    LoadTexture(vn->dialogues[0].characterSprite);
-			vn->hasTexture = true;
-		}
+		if (vn->dialogues[i].characterSprite[0] != '\0')
+			AssetCache_PrefetchTexture(vn->dialogues[i].characterSprite,
+			                           ASSET_LIFETIME_LEVEL, MEM_TAG_VN);
 	}
+	vn->portraitPending =
+	    vn->dialogueCount > 0 && vn->dialogues[0].characterSprite[0] != '\0';
 }
 void VN_Update(VNState *vn, float dt)
 {
 	if (vn->isComplete)
 		return;
 	VNDialogue *current = &vn->dialogues[vn->currentDialogue];
+	if (vn->portraitPending && !AssetCache_IsPending(current->characterSprite))
+	{
+		VN_AcquireTexture(vn, current->characterSprite);
+		vn->portraitPending = false;
+	}
 	int textLength = strlen(current->text);
 	vn->textTimer += dt;
 	if (vn->textTimer >= 0.03f)
@@ -75,18 +99,11 @@ void VN_Update(VNState *vn, float dt)
 				if (vn->hasTexture && strcmp(current->characterSprite,
 				                             next->characterSprite) != 0)
 				{
-					UnloadTexture(vn->characterTexture);
+					AssetCache_Release(vn->texturePath);
 					vn->hasTexture = false;
 				}
-				if (!vn->hasTexture && next->characterSprite[0] != '\0')
-				{
-					if (FileExists(next->characterSprite))
-					{
-						vn->characterTexture =
-						    LoadTexture(next->characterSprite);
-						vn->hasTexture = true;
-					}
-				}
+				vn->portraitPending =
+				    !vn->hasTexture && next->characterSprite[0] != '\0';
 			}
 		}
 	}
@@ -138,7 +155,7 @@ void VN_Unload(VNState *vn)
 {
 	if (vn->hasTexture)
 	{
-		UnloadTexture(vn->characterTexture);
+		AssetCache_Release(vn->texturePath);
 		vn->hasTexture = false;
 	}
 }
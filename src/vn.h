@@ -11,7 +11,9 @@ typedef struct
 	float textTimer;
 	bool isComplete;
 	Texture2D characterTexture;
+	char texturePath[64];
 	bool hasTexture;
+	bool portraitPending;
 } VNState;
 void VN_Init(VNState *vn, Level *level);
 void VN_Update(VNState *vn, float dt);
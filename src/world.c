@@ -18,13 +18,75 @@
 
 #include "world.h"
 #include "config.h"
+#include "counters.h"
+#include "loader.h"
+#include "manifest.h"
+#include "memtrack.h"
 #include "physics.h"
+#include "profiler.h"
+#include "render.h"
+#include "renderqueue.h"
+#include "trace.h"
 #include <math.h>
 #include <stdio.h>
+#ifndef CIRNO_HEADLESS
+// At most one level is decoded ahead of time, on a loader thread.
+static int preloadJob = -1;
+static int preloadIndex = -1;
+
+// Starts reading and decoding a level in the background so that the
+// World_Load for it only has to pick up the result.
+void World_Preload(int levelIndex)
+{
+	if (preloadIndex == levelIndex)
+		return;
+	World_CancelPreload();
+	const LevelManifestEntry *entry = Manifest_GetEntry(levelIndex);
+	if (!entry)
+		return;
+	preloadJob = Loader_QueueLevel(entry->path);
+	if (preloadJob >= 0)
+		preloadIndex = levelIndex;
+}
+void World_CancelPreload(void)
+{
+	if (preloadJob >= 0)
+		Loader_Cancel(preloadJob);
+	preloadJob = -1;
+	preloadIndex = -1;
+}
+bool World_IsPreloading(void)
+{
+	return preloadJob >= 0 && !Loader_IsDone(preloadJob);
+}
 void World_Load(World *world, int levelIndex)
 {
+	Trace_Begin("World_Load");
+	// Peaks from here on belong to this level.
+	Mem_ResetPeaks();
 	Assets_Load(&world->assets);
-	Level_Load(&world->level, levelIndex);
+	// A preload still in flight is waited on rather than started over.
+	bool preloaded = preloadIndex == levelIndex &&
+	                 Loader_TakeLevel(preloadJob, &world->level);
+	if (preloadIndex == levelIndex)
+	{
+		preloadJob = -1;
+		preloadIndex = -1;
+	}
+	else
+	{
+		World_CancelPreload();
+	}
+	if (!preloaded)
+		Level_Load(&world->level, levelIndex);
+	World_Populate(world);
+	Trace_End("World_Load");
+}
+#endif
+// Everything World_Load does after the level itself is in place, so tools
+// can start a world on a generated level.
+void World_Populate(World *world)
+{
 	Player_Init(&world->player, world->level.playerSpawn);
 	world->camera.target = world->player.position;
 	world->camera.offset = (Vector2){SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2};
@@ -34,6 +96,7 @@ void World_Load(World *world, int levelIndex)
 	world->bulletCount = 0;
 	world->collectibleCount = 0;
 	world->parryEffectCount = 0;
+	world->rng = Spawner_SeedFor(world->level.playerSpawn);
 
 	for (int y = 0; y < world->level.height; y++)
 	{
@@ -74,22 +137,30 @@ void World_Load(World *world, int levelIndex)
 		}
 	}
 }
+#ifndef CIRNO_HEADLESS
 void World_Unload(World *world)
 {
 	Level_Unload(&world->level);
 	Assets_Unload(&world->assets);
 }
-void World_Update(World *world, float dt, const KeyBindings *keys)
+#endif
+void World_Update(World *world, float dt, const PlayerInput *input)
 {
-	Player_Update(&world->player, dt, &world->assets, keys);
+	Trace_Begin("World_Update");
+	PROFILE_BEGIN(PROFILE_PLAYER);
+	Player_Update(&world->player, dt, &world->assets, input);
+	PROFILE_END(PROFILE_PLAYER);
+	PROFILE_BEGIN(PROFILE_PHYSICS);
 	Physics_ApplyGravity(&world->player, dt);
 	Physics_MoveX(&world->player, &world->level, dt);
 	Physics_MoveY(&world->player, &world->level, dt);
+	PROFILE_END(PROFILE_PHYSICS);
 	
 	// Check if player has fallen out of bounds
 	if (World_IsPlayerOutOfBounds(world))
 	{
 		world->player.health = 0;  // Instant death
+		Trace_End("World_Update");
 		return;
 	}
 	// Only update spawners within range of player for performance
@@ -100,6 +171,8 @@ void World_Update(World *world, float dt, const KeyBindings *keys)
 
 
 	const float MAX_SPAWNER_DIST_SQ = 2250000.0f; // 1500^2 (~30 tiles)
+	PROFILE_BEGIN(PROFILE_SPAWNERS);
+	int activeSpawners = 0;
 	for (int i = 0; i < world->spawnerCount; i++)
 	{
 		float dx = world->spawners[i].position.x - playerPos.x;
@@ -111,17 +184,25 @@ void World_Update(World *world, float dt, const KeyBindings *keys)
 			Spawner_Update(&world->spawners[i], world->bullets, &world->bulletCount,
 			               world->collectibles, &world->collectibleCount,
 			               world->player.position, dt);
+			activeSpawners += world->spawners[i].active;
 		}
 	}
+	Counters_Gauge(COUNTER_ACTIVE_SPAWNERS, activeSpawners);
+	Counters_Gauge(COUNTER_BULLETS_LIVE, world->bulletCount);
+	PROFILE_END(PROFILE_SPAWNERS);
+	PROFILE_BEGIN(PROFILE_BULLETS);
 	Bullet_Update(world->bullets, &world->bulletCount, &world->player, dt);
+	PROFILE_END(PROFILE_BULLETS);
 	Collectible_Update(world->collectibles, &world->collectibleCount, dt);
 	
 	Rectangle playerBounds = Player_GetBounds(&world->player);
 	
 	// Get current input state for parry detection
-	bool movingLeft = IsKeyDown(keys->moveLeft) || IsKeyDown(KEY_LEFT);
-	bool movingRight = IsKeyDown(keys->moveRight) || IsKeyDown(KEY_RIGHT);
+	bool movingLeft = input->left;
+	bool movingRight = input->right;
 	
+	PROFILE_BEGIN(PROFILE_COLLISIONS);
+	int collisionTests = 0;
 	// Only check bullet collisions if bullets exist
 	if (world->bulletCount > 0)
 	{
@@ -131,6 +212,7 @@ void World_Update(World *world, float dt, const KeyBindings *keys)
 			if (world->bullets[i].isParried)
 				continue;
 			
+			collisionTests++;
 			if (Bullet_CheckCollision(&world->bullets[i], playerBounds))
 			{
 				// Check if player can parry this bullet
@@ -142,10 +224,12 @@ void World_Update(World *world, float dt, const KeyBindings *keys)
 					world->bullets[i].velocity.x *= -PARRIED_BULLET_SPEED_MULTIPLIER;
 					world->bullets[i].velocity.y *= -PARRIED_BULLET_SPEED_MULTIPLIER;
 					world->bullets[i].isParried = true;
+					Counters_Add(COUNTER_PARRIES, 1);
 					
 					// Spawn health point reward at parry location
 					Collectible_Spawn(world->collectibles, &world->collectibleCount,
-					                 world->bullets[i].position, COLLECTIBLE_HEALTH_POINT);
+					                 world->bullets[i].position, COLLECTIBLE_HEALTH_POINT,
+					                 &world->rng);
 				}
 				else
 				{
@@ -169,6 +253,7 @@ void World_Update(World *world, float dt, const KeyBindings *keys)
 			if (!world->spawners[j].active)
 				continue;
 			
+			collisionTests++;
 			// Create rectangle for spawner hitbox (50x50 tile)
 			Rectangle spawnerBounds = {
 				world->spawners[j].position.x,
@@ -196,6 +281,8 @@ void World_Update(World *world, float dt, const KeyBindings *keys)
 			}
 		}
 	}
+	Counters_Add(COUNTER_COLLISION_TESTS, collisionTests);
+	PROFILE_END(PROFILE_COLLISIONS);
 	
 	int tileX = (int)((playerBounds.x + playerBounds.width / 2) / TILE_SIZE);
 	int tileY = (int)((playerBounds.y + playerBounds.height) / TILE_SIZE);
@@ -237,6 +324,7 @@ void World_Update(World *world, float dt, const KeyBindings *keys)
 		world->player.invulnerabilityTimer = 0;
 	}
 	
+	PROFILE_BEGIN(PROFILE_CAMERA);
 	// Calculate desired camera position (player center)
 	Vector2 desiredCamera = {
 		world->player.position.x + PLAYER_SIZE / 2,
@@ -280,6 +368,8 @@ void World_Update(World *world, float dt, const KeyBindings *keys)
 	                         world->camera.target.x * smoothing;
 	world->camera.target.y = desiredCamera.y * (1.0f - smoothing) +
 	                         world->camera.target.y * smoothing;
+	PROFILE_END(PROFILE_CAMERA);
+	Trace_End("World_Update");
 }
 
 bool World_IsPlayerOutOfBounds(const World *world)
@@ -307,20 +397,30 @@ bool World_IsPlayerOutOfBounds(const World *world)
 	return false;
 }
 
+#ifndef CIRNO_HEADLESS
 void World_Draw(const World *world)
 {
-	BeginMode2D(world->camera);
+	Render_BeginWorld(world->camera);
+	PROFILE_BEGIN(PROFILE_LEVEL_DRAW);
 	Level_Draw(&world->level, &world->assets, world->camera);
+	PROFILE_END(PROFILE_LEVEL_DRAW);
 	for (int i = 0; i < world->spawnerCount; i++)
 	{
 		Spawner_Draw(&world->spawners[i]);
 	}
+	PROFILE_BEGIN(PROFILE_BULLET_DRAW);
 	Bullet_Draw(world->bullets, world->bulletCount);
+	PROFILE_END(PROFILE_BULLET_DRAW);
 	Collectible_Draw(world->collectibles, world->collectibleCount);
 	Player_Draw(&world->player);
 	Player_DrawHitbox(&world->player);
-	EndMode2D();
+	// Everything above was only recorded; this is where it is drawn.
+	PROFILE_BEGIN(PROFILE_FLUSH);
+	RenderQueue_Flush();
+	Render_EndWorld();
+	PROFILE_END(PROFILE_FLUSH);
 }
+#endif
 bool World_LevelCompleted(const World *world)
 {
 	if (!world->level.hasGoal)
@@ -18,10 +18,15 @@ typedef struct
 	int collectibleCount;
 	ParryEffect parryEffects[MAX_PARRY_EFFECTS];
 	int parryEffectCount;
+	unsigned int rng; // for randomness not owned by a spawner
 } World;
+void World_Preload(int levelIndex);
+void World_CancelPreload(void);
+bool World_IsPreloading(void);
 void World_Load(World *world, int levelIndex);
+void World_Populate(World *world);
 void World_Unload(World *world);
-void World_Update(World *world, float dt, const KeyBindings *keys);
+void World_Update(World *world, float dt, const PlayerInput *input);
 void World_Draw(const World *world);
 bool World_LevelCompleted(const World *world);
 bool World_IsPlayerOutOfBounds(const World *world);
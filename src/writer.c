@@ -0,0 +1,252 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include "writer.h"
+#include "memtrack.h"
+#include "trace.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+// Kept out of every other file: windows.h clashes with raylib's names.
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Enough for every file the game writes to be queued at once.
+#define WRITER_MAX_JOBS 16
+
+typedef struct
+{
+	bool used;
+	bool busy; // being written right now; a newer write needs its own job
+	unsigned int order;
+	char path[256];
+	unsigned char *data;
+	int size;
+} WriterJob;
+
+static WriterJob jobs[WRITER_MAX_JOBS];
+static pthread_t worker;
+static bool running = false;
+static bool stopping = false;
+static unsigned int nextOrder = 0;
+static pthread_mutex_t jobLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobQueued = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t jobDone = PTHREAD_COND_INITIALIZER;
+
+// The rename only survives a power cut once the directory entry itself is
+// on disk too.
+static void Writer_SyncDirectory(const char *path)
+{
+#ifndef _WIN32
+	char dir[256];
+	strncpy(dir, path, sizeof(dir) - 1);
+	dir[sizeof(dir) - 1] = '\0';
+	char *slash = strrchr(dir, '/');
+	if (slash)
+		*slash = '\0';
+	else
+		strcpy(dir, ".");
+	int fd = open(dir, O_RDONLY);
+	if (fd >= 0)
+	{
+		fsync(fd);
+		close(fd);
+	}
+#endif
+}
+bool Writer_WriteFile(const char *path, const void *data, int size)
+{
+	char temp[272];
+	snprintf(temp, sizeof(temp), "%s.tmp", path);
+	FILE *f = fopen(temp, "wb");
+	if (!f)
+		return false;
+	bool ok = fwrite(data, 1, size, f) == (size_t)size && fflush(f) == 0;
+#ifdef _WIN32
+	ok = ok && _commit(_fileno(f)) == 0;
+#else
+	ok = ok && fsync(fileno(f)) == 0;
+#endif
+	ok = fclose(f) == 0 && ok;
+#ifdef _WIN32
+	ok = ok && MoveFileExA(temp, path,
+	                       MOVEFILE_REPLACE_EXISTING |
+	                           MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	ok = ok && rename(temp, path) == 0;
+#endif
+	if (!ok)
+	{
+		remove(temp);
+		fprintf(stderr, "WRITER: could not write %s\n", path);
+		return false;
+	}
+	Writer_SyncDirectory(path);
+	return true;
+}
+static WriterJob *Writer_NextJob(void)
+{
+	WriterJob *next = NULL;
+	for (int i = 0; i < WRITER_MAX_JOBS; i++)
+	{
+		if (jobs[i].used && !jobs[i].busy &&
+		    (!next || jobs[i].order < next->order))
+			next = &jobs[i];
+	}
+	return next;
+}
+// Keeps going after Writer_Shutdown until everything queued is on disk.
+static void *Writer_Worker(void *arg)
+{
+	pthread_mutex_lock(&jobLock);
+	for (;;)
+	{
+		WriterJob *job = Writer_NextJob();
+		if (!job)
+		{
+			if (stopping)
+				break;
+			pthread_cond_wait(&jobQueued, &jobLock);
+			continue;
+		}
+		job->busy = true;
+		pthread_mutex_unlock(&jobLock);
+
+		Trace_Begin("Write file");
+		Writer_WriteFile(job->path, job->data, job->size);
+		Trace_End("Write file");
+
+		pthread_mutex_lock(&jobLock);
+		Mem_Free(job->data);
+		memset(job, 0, sizeof(WriterJob));
+		pthread_cond_broadcast(&jobDone);
+	}
+	pthread_mutex_unlock(&jobLock);
+	return NULL;
+}
+bool Writer_Init(void)
+{
+	stopping = false;
+	running = pthread_create(&worker, NULL, Writer_Worker, NULL) == 0;
+	return running;
+}
+void Writer_Shutdown(void)
+{
+	if (!running)
+		return;
+	pthread_mutex_lock(&jobLock);
+	stopping = true;
+	pthread_cond_broadcast(&jobQueued);
+	pthread_mutex_unlock(&jobLock);
+	pthread_join(worker, NULL);
+	running = false;
+}
+// Copies the data, so the caller's buffer can be reused straight away.
+// Without the thread the write happens right here the same crash-safe way.
+// With the queue full it waits for the worker to free a job instead: the
+// worker may be writing this very path, and two writers would share the
+// temp file and could rename the older contents over the newer.
+bool Writer_Submit(const char *path, const void *data, int size)
+{
+	if (!running)
+		return Writer_WriteFile(path, data, size);
+	// Nearly everything written is a save, settings or achievements.
+	unsigned char *copy =
+	    (unsigned char *)Mem_Alloc(MEM_TAG_SAVES, size > 0 ? size : 1);
+	if (!copy)
+		return false;
+	memcpy(copy, data, size);
+	pthread_mutex_lock(&jobLock);
+	WriterJob *job = NULL;
+	WriterJob *empty = NULL;
+	for (;;)
+	{
+		for (int i = 0; i < WRITER_MAX_JOBS; i++)
+		{
+			if (jobs[i].used && !jobs[i].busy &&
+			    strcmp(jobs[i].path, path) == 0)
+				job = &jobs[i];
+			else if (!jobs[i].used && !empty)
+				empty = &jobs[i];
+		}
+		if (job || empty)
+			break;
+		pthread_cond_wait(&jobDone, &jobLock);
+	}
+	if (job)
+	{
+		// Still waiting its turn, so only the newest contents matter.
+		Mem_Free(job->data);
+	}
+	else if (empty)
+	{
+		job = empty;
+		job->used = true;
+		job->order = nextOrder++;
+		strncpy(job->path, path, sizeof(job->path) - 1);
+	}
+	job->data = copy;
+	job->size = size;
+	pthread_cond_signal(&jobQueued);
+	pthread_mutex_unlock(&jobLock);
+	return true;
+}
+// Waits until everything submitted so far is on disk.
+void Writer_Flush(void)
+{
+	pthread_mutex_lock(&jobLock);
+	for (;;)
+	{
+		bool pending = false;
+		for (int i = 0; i < WRITER_MAX_JOBS; i++)
+			pending = pending || jobs[i].used;
+		if (!pending)
+			break;
+		pthread_cond_wait(&jobDone, &jobLock);
+	}
+	pthread_mutex_unlock(&jobLock);
+}
+// Lists the files waiting for or being written, separated by spaces, for
+// the hitch log. Returns how many there are.
+int Writer_DescribePending(char *paths, int size)
+{
+	int count = 0;
+	int used = 0;
+	paths[0] = '\0';
+	pthread_mutex_lock(&jobLock);
+	for (int i = 0; i < WRITER_MAX_JOBS; i++)
+	{
+		if (!jobs[i].used)
+			continue;
+		count++;
+		if (used < size)
+			used += snprintf(paths + used, size - used, "%s%s",
+			                 used > 0 ? " " : "", jobs[i].path);
+	}
+	pthread_mutex_unlock(&jobLock);
+	return count;
+}
@@ -0,0 +1,17 @@
+#ifndef WRITER_H
+#define WRITER_H
+#include <stdbool.h>
+// Writes whole files from a background thread. Each write goes to
+// "<path>.tmp", is flushed to disk and then renamed over the old file, so
+// a crash leaves either the previous contents or the new ones, never half
+// of each. Writing a path again before its earlier write has started
+// replaces that write instead of queueing another.
+bool Writer_Init(void);
+void Writer_Shutdown(void);
+bool Writer_Submit(const char *path, const void *data, int size);
+// Writes on the calling thread, the same crash-safe way, and returns once
+// the file is in place.
+bool Writer_WriteFile(const char *path, const void *data, int size);
+void Writer_Flush(void);
+int Writer_DescribePending(char *paths, int size);
+#endif
@@ -0,0 +1,422 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Batch level validation: "make batchsim".
+//
+// Plays many independent instances of each level at once, spread over
+// every core, through the headless simulation library (src/sim.h). Each
+// instance follows an input policy. "script" runs right and jumps in a
+// rhythm whose period and phase differ per instance; "random" holds random
+// inputs for random stretches, seeded per instance. A dead instance goes
+// back to its last checkpoint, as in the game, until it reaches the goal
+// or runs out of ticks.
+//
+//   batchsim [--instances N] [--ticks N] [--threads N]
+//            [--policy script|random] [--seed N] [--gen]
+//            [--require-goal] [LEVEL...]
+//
+// Per level it reports how many instances completed or timed out, deaths
+// per instance, the median ticks to the goal, the most bullets alive at
+// once and the simulated ticks per second of one core. Neither policy
+// plays well enough to clear the shipped levels, so by default this is a
+// stress and survival run: it shows where instances die, how many bullets
+// pile up and that nothing crashes or soft-locks the simulation, and it
+// exits 0 once every instance has run. Many deaths per instance point at a
+// difficulty spike. --require-goal makes a level nobody completes an error,
+// for levels and policies that can finish. --gen adds the generated stress
+// profiles that fit the game's world size. Exits 1 when --require-goal
+// fails and 2 on bad arguments or unreadable levels.
+#define _POSIX_C_SOURCE 200112L
+#include "levelgen.h"
+#include "pack.h"
+#include "sim.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BATCHSIM_INSTANCES 256
+#define BATCHSIM_TICKS (TARGET_FPS * 120) // two minutes of play
+#define BATCHSIM_MAX_THREADS 64
+#define BATCHSIM_MAX_LEVELS 128
+#define BATCHSIM_SEED 1u
+
+typedef enum
+{
+	BATCHSIM_POLICY_SCRIPT,
+	BATCHSIM_POLICY_RANDOM
+} BatchsimPolicy;
+typedef struct
+{
+	char name[64];
+	Level level;
+	Sim *start; // cloned into a worker's Sim for every instance
+} BatchsimLevel;
+// One per instance, written only by the worker that ran it.
+typedef struct
+{
+	bool completed;
+	int deaths;
+	int ticks;
+	int bulletPeak;
+	double seconds;
+} BatchsimResult;
+
+static BatchsimLevel levels[BATCHSIM_MAX_LEVELS];
+static int levelCount = 0;
+static BatchsimResult *results = NULL;
+static int instanceCount = BATCHSIM_INSTANCES;
+static int tickLimit = BATCHSIM_TICKS;
+static BatchsimPolicy policy = BATCHSIM_POLICY_SCRIPT;
+static unsigned int seed = BATCHSIM_SEED;
+static int nextJob = 0;
+static pthread_mutex_t jobLock = PTHREAD_MUTEX_INITIALIZER;
+
+static void Batchsim_Usage(void)
+{
+	fprintf(stderr,
+	        "usage: batchsim [options] [LEVEL...]\n"
+	        "  --instances N      instances per level (default %d)\n"
+	        "  --ticks N          tick limit per instance (default %d)\n"
+	        "  --threads N        worker threads (default: one per core)\n"
+	        "  --policy P         script or random (default script)\n"
+	        "  --seed N           seed for the random policy (default %u)\n"
+	        "  --gen              add the generated stress profiles\n"
+	        "  --require-goal     fail when a level is never completed\n",
+	        BATCHSIM_INSTANCES, BATCHSIM_TICKS, BATCHSIM_SEED);
+}
+static bool Batchsim_ParsePolicy(const char *name)
+{
+	if (strcmp(name, "script") == 0)
+		policy = BATCHSIM_POLICY_SCRIPT;
+	else if (strcmp(name, "random") == 0)
+		policy = BATCHSIM_POLICY_RANDOM;
+	else
+		return false;
+	return true;
+}
+static double Batchsim_Now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+static int Batchsim_CoreCount(void)
+{
+#ifdef _WIN32
+	const char *cores = getenv("NUMBER_OF_PROCESSORS");
+	int count = cores ? atoi(cores) : 1;
+#else
+	int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return count > 0 ? count : 1;
+}
+// Instance i jumps every 30-60 ticks, holding up for half the period, and
+// dashes, floats and slows down on its own offsets.
+static unsigned int Batchsim_Script(int instance, int tick)
+{
+	int period = 30 + instance % 31;
+	int phase = (tick + instance * 7) % period;
+	unsigned int input = SIM_INPUT_RIGHT;
+	if (phase < period / 2)
+		input |= SIM_INPUT_JUMP;
+	if ((tick + instance * 13) % 240 < 2)
+		input |= SIM_INPUT_DASH;
+	if ((tick + instance * 29) % 600 < 2)
+		input |= SIM_INPUT_FLOAT;
+	if ((tick + instance * 11) % 300 >= 200 && (tick + instance) % 300 < 230)
+		input |= SIM_INPUT_SLOW;
+	if (tick % 120 == 0)
+		input |= SIM_INPUT_HEAL;
+	return input;
+}
+// Mostly heads right, since that is where levels tend to go, but turns
+// back and stands still often enough to find routes that need it.
+static unsigned int Batchsim_RandomInput(unsigned int *rng)
+{
+	unsigned int roll = Spawner_Random(rng) % 100;
+	unsigned int input = roll < 65   ? SIM_INPUT_RIGHT
+	                     : roll < 85 ? SIM_INPUT_LEFT
+	                                 : 0;
+	unsigned int bits = Spawner_Random(rng);
+	if (bits & 1)
+		input |= SIM_INPUT_JUMP;
+	if ((bits & 0x0E) == 0)
+		input |= SIM_INPUT_DASH;
+	if ((bits & 0x70) == 0)
+		input |= SIM_INPUT_FLOAT;
+	if ((bits & 0x180) == 0)
+		input |= SIM_INPUT_DOWN;
+	if ((bits & 0x600) == 0)
+		input |= SIM_INPUT_CLING;
+	if ((bits & 0x3800) == 0)
+		input |= SIM_INPUT_SLOW;
+	if ((bits & 0xC000) == 0)
+		input |= SIM_INPUT_HEAL;
+	return input;
+}
+static void Batchsim_Play(Sim *sim, int level, int instance)
+{
+	BatchsimResult *result = &results[level * instanceCount + instance];
+	double start = Batchsim_Now();
+	Sim_Clone(sim, levels[level].start);
+	unsigned int rng = seed * 2654435761u ^ (unsigned int)instance * 40503u ^
+	                   (unsigned int)level * 9973u;
+	if (rng == 0)
+		rng = 1;
+	unsigned int input = 0;
+	int hold = 0;
+	SimStatus status = SIM_RUNNING;
+	int deaths = 0;
+	int bulletPeak = 0;
+	int tick = 0;
+	for (; tick < tickLimit && status != SIM_COMPLETED; tick++)
+	{
+		if (status == SIM_DEAD)
+		{
+			deaths++;
+			Sim_Respawn(sim);
+		}
+		if (policy == BATCHSIM_POLICY_SCRIPT)
+			input = Batchsim_Script(instance, tick);
+		else if (hold-- <= 0)
+		{
+			input = Batchsim_RandomInput(&rng);
+			hold = 6 + (int)(Spawner_Random(&rng) % 25);
+		}
+		status = Sim_Step(sim, input);
+		if (sim->world.bulletCount > bulletPeak)
+			bulletPeak = sim->world.bulletCount;
+	}
+	// A death on the last tick never reached the respawn above.
+	if (status == SIM_DEAD)
+		deaths++;
+	result->completed = status == SIM_COMPLETED;
+	result->deaths = deaths;
+	result->ticks = tick;
+	result->bulletPeak = bulletPeak;
+	result->seconds = Batchsim_Now() - start;
+}
+// Workers take instances in order, so the levels finish roughly in turn.
+static void *Batchsim_Worker(void *arg)
+{
+	(void)arg;
+	Sim *sim = NULL;
+	int jobCount = levelCount * instanceCount;
+	for (;;)
+	{
+		pthread_mutex_lock(&jobLock);
+		int job = nextJob < jobCount ? nextJob++ : -1;
+		pthread_mutex_unlock(&jobLock);
+		if (job < 0)
+			break;
+		int level = job / instanceCount;
+		if (!sim)
+			sim = Sim_Create(&levels[level].level);
+		if (!sim)
+			break;
+		Batchsim_Play(sim, level, job % instanceCount);
+	}
+	Sim_Destroy(sim);
+	return NULL;
+}
+static int Batchsim_CompareInts(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+// Prints one level's row; returns whether any instance completed it.
+static bool Batchsim_Report(int level, int *completedTicks)
+{
+	const BatchsimResult *r = &results[level * instanceCount];
+	int completed = 0;
+	long long deaths = 0;
+	int bulletPeak = 0;
+	long long ticks = 0;
+	double seconds = 0.0;
+	for (int i = 0; i < instanceCount; i++)
+	{
+		if (r[i].completed)
+			completedTicks[completed++] = r[i].ticks;
+		deaths += r[i].deaths;
+		if (r[i].bulletPeak > bulletPeak)
+			bulletPeak = r[i].bulletPeak;
+		ticks += r[i].ticks;
+		seconds += r[i].seconds;
+	}
+	char median[16] = "-";
+	if (completed > 0)
+	{
+		qsort(completedTicks, completed, sizeof(int), Batchsim_CompareInts);
+		snprintf(median, sizeof(median), "%d",
+		         completedTicks[(completed - 1) / 2]);
+	}
+	printf("%-24s %6d %6d %7.1f %9s %8d %10.0f\n", levels[level].name,
+	       completed, instanceCount - completed,
+	       (double)deaths / instanceCount, median, bulletPeak,
+	       seconds > 0.0 ? ticks / seconds : 0.0);
+	return completed > 0;
+}
+static bool Batchsim_AddLevel(const char *name)
+{
+	if (levelCount >= BATCHSIM_MAX_LEVELS)
+		return false;
+	BatchsimLevel *entry = &levels[levelCount];
+	snprintf(entry->name, sizeof(entry->name), "%s", name);
+	entry->start = Sim_Create(&entry->level);
+	if (!entry->start)
+	{
+		Level_Unload(&entry->level);
+		return false;
+	}
+	levelCount++;
+	return true;
+}
+static bool Batchsim_LoadFile(const char *path)
+{
+	if (!Pack_Exists(path))
+	{
+		fprintf(stderr, "batchsim: cannot read %s\n", path);
+		return false;
+	}
+	if (levelCount >= BATCHSIM_MAX_LEVELS)
+		return false;
+	if (!Level_TryLoadFromFile(&levels[levelCount].level, path))
+	{
+		fprintf(stderr, "batchsim: %s is not a valid level\n", path);
+		return false;
+	}
+	const char *name = strrchr(path, '/');
+	return Batchsim_AddLevel(name ? name + 1 : path);
+}
+// Profiles bigger than the game allows are left to the benchmarks.
+static void Batchsim_LoadGenerated(void)
+{
+	for (int i = 0; i < LEVELGEN_PROFILE_COUNT; i++)
+	{
+		LevelGenOptions options;
+		const char *profile = LevelGen_GetProfileName(i);
+		if (levelCount >= BATCHSIM_MAX_LEVELS ||
+		    !LevelGen_GetProfile(profile, &options) ||
+		    options.width > MAX_WORLD_WIDTH ||
+		    options.height > MAX_WORLD_HEIGHT ||
+		    !LevelGen_Generate(&levels[levelCount].level, &options))
+			continue;
+		char name[64];
+		snprintf(name, sizeof(name), "gen-%s", profile);
+		Batchsim_AddLevel(name);
+	}
+}
+int main(int argc, char **argv)
+{
+	int threadCount = Batchsim_CoreCount();
+	bool generated = false;
+	bool requireGoal = false;
+	int a = 1;
+	for (; a < argc && strncmp(argv[a], "--", 2) == 0; a++)
+	{
+		bool hasValue = a + 1 < argc;
+		if (strcmp(argv[a], "--instances") == 0 && hasValue)
+			instanceCount = atoi(argv[++a]);
+		else if (strcmp(argv[a], "--ticks") == 0 && hasValue)
+			tickLimit = atoi(argv[++a]);
+		else if (strcmp(argv[a], "--threads") == 0 && hasValue)
+			threadCount = atoi(argv[++a]);
+		else if (strcmp(argv[a], "--seed") == 0 && hasValue)
+			seed = (unsigned int)strtoul(argv[++a], NULL, 10);
+		else if (strcmp(argv[a], "--policy") == 0 && hasValue &&
+		         Batchsim_ParsePolicy(argv[a + 1]))
+			a++;
+		else if (strcmp(argv[a], "--gen") == 0)
+			generated = true;
+		else if (strcmp(argv[a], "--require-goal") == 0)
+			requireGoal = true;
+		else
+		{
+			Batchsim_Usage();
+			return 2;
+		}
+	}
+	if (instanceCount <= 0 || tickLimit <= 0 || threadCount <= 0 ||
+	    (a >= argc && !generated))
+	{
+		Batchsim_Usage();
+		return 2;
+	}
+	if (threadCount > BATCHSIM_MAX_THREADS)
+		threadCount = BATCHSIM_MAX_THREADS;
+
+	// Levels not found loose are looked up in the pack.
+	Pack_Open(ASSET_PACK_PATH);
+	bool ok = true;
+	for (; a < argc && ok; a++)
+		ok = Batchsim_LoadFile(argv[a]);
+	if (ok && generated)
+		Batchsim_LoadGenerated();
+	results = calloc((size_t)levelCount * instanceCount,
+	                 sizeof(BatchsimResult));
+	int *completedTicks = malloc(sizeof(int) * instanceCount);
+	if (!ok || !results || !completedTicks)
+		return 2;
+
+	printf("%d levels x %d instances, %d ticks max, %s policy, "
+	       "%d threads\n",
+	       levelCount, instanceCount, tickLimit,
+	       policy == BATCHSIM_POLICY_SCRIPT ? "script" : "random",
+	       threadCount);
+	double start = Batchsim_Now();
+	pthread_t threads[BATCHSIM_MAX_THREADS];
+	int started = 0;
+	for (; started < threadCount; started++)
+		if (pthread_create(&threads[started], NULL, Batchsim_Worker, NULL))
+			break;
+	if (started == 0)
+		Batchsim_Worker(NULL);
+	for (int i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
+	double elapsed = Batchsim_Now() - start;
+
+	printf("%-24s %6s %6s %7s %9s %8s %10s\n", "level", "done", "time",
+	       "deaths", "ticks p50", "bullets", "ticks/s");
+	int unfinished = 0;
+	long long totalTicks = 0;
+	for (int i = 0; i < levelCount; i++)
+	{
+		if (!Batchsim_Report(i, completedTicks))
+			unfinished++;
+		for (int j = 0; j < instanceCount; j++)
+			totalTicks += results[i * instanceCount + j].ticks;
+	}
+	printf("%lld ticks in %.2f s, %.0f ticks/s over %d threads\n",
+	       totalTicks, elapsed, elapsed > 0.0 ? totalTicks / elapsed : 0.0,
+	       started > 0 ? started : 1);
+	printf("%s: %d of %d levels never completed\n",
+	       unfinished && requireGoal ? "FAIL" : "ok", unfinished, levelCount);
+
+	for (int i = 0; i < levelCount; i++)
+	{
+		Sim_Destroy(levels[i].start);
+		Level_Unload(&levels[i].level);
+	}
+	free(results);
+	free(completedTicks);
+	Pack_Close();
+	return unfinished && requireGoal ? 1 : 0;
+}
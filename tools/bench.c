@@ -0,0 +1,382 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Micro-benchmarks for the simulation core: "make bench".
+//
+// Each benchmark is calibrated to a batch of operations that takes at
+// least BENCH_MIN_SAMPLE seconds, warmed up for BENCH_WARMUP batches and
+// then timed for BENCH_SAMPLES batches. The report gives ns/op (median,
+// min and relative standard deviation over the samples) and throughput in
+// the benchmark's own unit (bullets, tiles, bytes, files).
+//
+// Runs from the repository root; scratch files go under build/bench.
+#define _POSIX_C_SOURCE 200112L
+#include "level.h"
+#include "levelgen.h"
+#include "physics.h"
+#include "save.h"
+#include "spawner.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(dir, mode) _mkdir(dir)
+#endif
+
+#define BENCH_MIN_SAMPLE 0.01
+#define BENCH_WARMUP 3
+#define BENCH_SAMPLES 15
+#define BENCH_DIR "build/bench"
+#define BENCH_BIG_LEVEL BENCH_DIR "/big.lvl"
+#define BENCH_SAVE_COUNT 300
+
+typedef struct
+{
+	const char *name;
+	const char *unit;   // what one op processes, for the throughput column
+	double unitsPerOp;  // filled in by setup
+	void (*setup)(void);
+	void (*run)(void);  // one op
+	void (*teardown)(void);
+} Benchmark;
+
+static double Bench_Now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+static double Bench_TimeBatch(const Benchmark *b, long ops)
+{
+	double start = Bench_Now();
+	for (long i = 0; i < ops; i++)
+		b->run();
+	return Bench_Now() - start;
+}
+static int Bench_CompareDoubles(const void *a, const void *b)
+{
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+static void Bench_Run(Benchmark *b)
+{
+	if (b->setup)
+		b->setup();
+	long ops = 1;
+	while (Bench_TimeBatch(b, ops) < BENCH_MIN_SAMPLE && ops < (1L << 30))
+		ops *= 2;
+	for (int i = 0; i < BENCH_WARMUP; i++)
+		Bench_TimeBatch(b, ops);
+	double samples[BENCH_SAMPLES];
+	double mean = 0.0;
+	for (int i = 0; i < BENCH_SAMPLES; i++)
+	{
+		samples[i] = Bench_TimeBatch(b, ops) * 1e9 / ops;
+		mean += samples[i];
+	}
+	mean /= BENCH_SAMPLES;
+	double variance = 0.0;
+	for (int i = 0; i < BENCH_SAMPLES; i++)
+		variance += (samples[i] - mean) * (samples[i] - mean);
+	double stddev = sqrt(variance / (BENCH_SAMPLES - 1));
+	qsort(samples, BENCH_SAMPLES, sizeof(double), Bench_CompareDoubles);
+	double median = samples[BENCH_SAMPLES / 2];
+	double throughput = b->unitsPerOp * 1e9 / median;
+	printf("%-34s %12.1f %12.1f %6.1f%% %12.3g %s/s\n", b->name, median,
+	       samples[0], 100.0 * stddev / mean, throughput, b->unit);
+	if (b->teardown)
+		b->teardown();
+}
+
+// Bullet_Update ------------------------------------------------------------
+// The bullets fly back and forth (dt flips sign every op), so the same
+// set stays alive for the whole run.
+static Bullet bullets[8192];
+static int bulletCount = 0;
+static int bulletTarget = 0;
+static Player player;
+static float bulletDt = 1.0f / 60.0f;
+
+static void Bench_SetupBullets(int count)
+{
+	Player_Init(&player, (Vector2){1000, 1000});
+	bulletTarget = count;
+	bulletCount = count;
+	srand(1);
+	for (int i = 0; i < count; i++)
+	{
+		float angle = (float)i * 0.61803f * 2.0f * PI;
+		float distance = (float)(rand() % 250);
+		bullets[i] = (Bullet){
+		    .position = {1000 + cosf(angle) * distance,
+		                 1000 + sinf(angle) * distance},
+		    .velocity = {cosf(angle) * 150.0f, sinf(angle) * 150.0f},
+		    .radius = 6.0f,
+		    .active = true,
+		    .color = RED};
+	}
+}
+static void Bench_SetupBullets100(void) { Bench_SetupBullets(100); }
+static void Bench_SetupBullets500(void) { Bench_SetupBullets(500); }
+static void Bench_SetupBullets5k(void) { Bench_SetupBullets(5000); }
+static void Bench_RunBullets(void)
+{
+	Bullet_Update(bullets, &bulletCount, &player, bulletDt);
+	bulletDt = -bulletDt;
+}
+static void Bench_TeardownBullets(void)
+{
+	if (bulletCount != bulletTarget)
+		printf("  (warning: %d of %d bullets despawned)\n",
+		       bulletTarget - bulletCount, bulletTarget);
+}
+
+// Spawner patterns ---------------------------------------------------------
+// Each op fires one volley into an empty array; throughput counts the
+// bullets one volley produces.
+static BulletSpawner spawner;
+static Benchmark *currentBenchmark = NULL;
+
+static void Bench_SetupSpawner(SpawnerPattern pattern)
+{
+	Spawner_Init(&spawner, (Vector2){500, 500}, pattern);
+	currentBenchmark->run();
+	currentBenchmark->unitsPerOp = bulletCount;
+}
+static void Bench_SetupCircle(void)
+{
+	Bench_SetupSpawner(SPAWNER_PATTERN_CIRCLE);
+}
+static void Bench_SetupSpiral(void)
+{
+	Bench_SetupSpawner(SPAWNER_PATTERN_SPIRAL);
+}
+static void Bench_SetupWave(void) { Bench_SetupSpawner(SPAWNER_PATTERN_WAVE); }
+static void Bench_SetupBurst(void)
+{
+	Bench_SetupSpawner(SPAWNER_PATTERN_BURST);
+}
+static void Bench_SetupTargeting(void)
+{
+	Bench_SetupSpawner(SPAWNER_PATTERN_TARGETING);
+}
+static void Bench_RunCircle(void)
+{
+	bulletCount = 0;
+	Spawner_PatternCircle(&spawner, bullets, &bulletCount);
+}
+static void Bench_RunSpiral(void)
+{
+	bulletCount = 0;
+	Spawner_PatternSpiral(&spawner, bullets, &bulletCount);
+}
+static void Bench_RunWave(void)
+{
+	bulletCount = 0;
+	Spawner_PatternWave(&spawner, bullets, &bulletCount);
+}
+static void Bench_RunBurst(void)
+{
+	bulletCount = 0;
+	Spawner_PatternBurst(&spawner, bullets, &bulletCount);
+}
+static void Bench_RunTargeting(void)
+{
+	bulletCount = 0;
+	Spawner_PatternTargeting(&spawner, bullets, &bulletCount,
+	                         (Vector2){800, 700});
+}
+
+// Physics ------------------------------------------------------------------
+// A 128x128 map of solid stone with a one-tile-wide shaft and corridor
+// carved through it, so every move ends against a wall.
+static Level level;
+
+static void Bench_SetupPhysics(void)
+{
+	Level_Create(&level, 128, 128);
+	for (int y = 0; y < level.height; y++)
+	{
+		for (int x = 0; x < level.width; x++)
+		{
+			bool open = (x == 64 && y > 10 && y < 118) ||
+			            (y == 64 && x > 10 && x < 118);
+			Level_SetTile(&level, x, y, open ? TILE_EMPTY : TILE_STONE);
+		}
+	}
+	Player_Init(&player, (Vector2){64 * TILE_SIZE + 5, 64 * TILE_SIZE + 5});
+}
+static void Bench_RunMoveX(void)
+{
+	player.position = (Vector2){64 * TILE_SIZE + 5, 64 * TILE_SIZE + 5};
+	player.velocity = (Vector2){(bulletDt > 0 ? 1 : -1) * 600.0f, 0};
+	bulletDt = -bulletDt;
+	Physics_MoveX(&player, &level, 1.0f / 60.0f);
+}
+static void Bench_RunMoveY(void)
+{
+	player.position = (Vector2){64 * TILE_SIZE + 5, 64 * TILE_SIZE + 5};
+	player.velocity = (Vector2){0, (bulletDt > 0 ? 1 : -1) * 600.0f};
+	bulletDt = -bulletDt;
+	Physics_MoveY(&player, &level, 1.0f / 60.0f);
+}
+static void Bench_TeardownLevel(void) { Level_Unload(&level); }
+
+// Level loading ------------------------------------------------------------
+static const char *levelPath = NULL;
+
+static long Bench_FileSize(const char *path)
+{
+	struct stat st;
+	return stat(path, &st) == 0 ? (long)st.st_size : 0;
+}
+static void Bench_RunLevelLoad(void)
+{
+	Level_LoadFromFile(&level, levelPath);
+	Level_Unload(&level);
+}
+static void Bench_SetupSmallLevel(void)
+{
+	levelPath = "assets/levels/1.lvl";
+	currentBenchmark->unitsPerOp = (double)Bench_FileSize(levelPath);
+}
+// The "dense" stress profile from tools/lvlgen.c: a full-size map with
+// crowded platform rows and a noisy background layer.
+static void Bench_SetupBigLevel(void)
+{
+	Level big;
+	LevelGenOptions options;
+	LevelGen_GetProfile("dense", &options);
+	if (LevelGen_Generate(&big, &options))
+	{
+		Level_SaveToFile(&big, BENCH_BIG_LEVEL);
+		Level_Unload(&big);
+	}
+	levelPath = BENCH_BIG_LEVEL;
+	currentBenchmark->unitsPerOp = (double)Bench_FileSize(levelPath);
+}
+
+// Save listing -------------------------------------------------------------
+// save.c works relative to the current directory, so these run inside
+// build/bench with their own saves/. Each benchmark writes the saves and
+// removes them again, so either one can run alone.
+static char benchCwd[1024];
+static bool benchInSaveDir = false;
+
+static void Bench_SetupSaves(void)
+{
+	GameData data;
+	memset(&data, 0, sizeof(data));
+	Achievement_Init(&data.achievements);
+	if (!getcwd(benchCwd, sizeof(benchCwd)) || chdir(BENCH_DIR) != 0)
+	{
+		fprintf(stderr, "bench: could not enter %s\n", BENCH_DIR);
+		return;
+	}
+	benchInSaveDir = true;
+	for (int i = 0; i < BENCH_SAVE_COUNT; i++)
+	{
+		snprintf(data.saveName, sizeof(data.saveName), "Bench_%d", i);
+		data.currentLevel = i % 9;
+		data.deathCount = i;
+		data.isValid = true;
+		Save_Write(&data, TextFormat("%s.sav", data.saveName));
+	}
+	currentBenchmark->unitsPerOp = BENCH_SAVE_COUNT;
+}
+static void Bench_RunSaveScan(void)
+{
+	int count = 0;
+	Save_InvalidateList();
+	Save_GetSaveList(&count);
+}
+static void Bench_RunSaveCached(void)
+{
+	int count = 0;
+	Save_GetSaveList(&count);
+}
+static void Bench_TeardownSaves(void)
+{
+	if (!benchInSaveDir)
+		return;
+	for (int i = 0; i < BENCH_SAVE_COUNT; i++)
+		Save_DeleteSave(TextFormat("Bench_%d.sav", i));
+	Save_InvalidateList();
+	if (chdir(benchCwd) != 0)
+		fprintf(stderr, "bench: could not return to %s\n", benchCwd);
+	benchInSaveDir = false;
+}
+
+static Benchmark benchmarks[] = {
+    {"Bullet_Update 100", "bullets", 100, Bench_SetupBullets100,
+     Bench_RunBullets, Bench_TeardownBullets},
+    {"Bullet_Update 500", "bullets", 500, Bench_SetupBullets500,
+     Bench_RunBullets, Bench_TeardownBullets},
+    {"Bullet_Update 5k", "bullets", 5000, Bench_SetupBullets5k,
+     Bench_RunBullets, Bench_TeardownBullets},
+    {"Spawner_PatternCircle", "bullets", 0, Bench_SetupCircle, Bench_RunCircle,
+     NULL},
+    {"Spawner_PatternSpiral", "bullets", 0, Bench_SetupSpiral, Bench_RunSpiral,
+     NULL},
+    {"Spawner_PatternWave", "bullets", 0, Bench_SetupWave, Bench_RunWave, NULL},
+    {"Spawner_PatternBurst", "bullets", 0, Bench_SetupBurst, Bench_RunBurst,
+     NULL},
+    {"Spawner_PatternTargeting", "bullets", 0, Bench_SetupTargeting,
+     Bench_RunTargeting, NULL},
+    {"Physics_MoveX dense 128x128", "moves", 1, Bench_SetupPhysics,
+     Bench_RunMoveX, Bench_TeardownLevel},
+    {"Physics_MoveY dense 128x128", "moves", 1, Bench_SetupPhysics,
+     Bench_RunMoveY, Bench_TeardownLevel},
+    {"Level_LoadFromFile small", "bytes", 0, Bench_SetupSmallLevel,
+     Bench_RunLevelLoad, NULL},
+    {"Level_LoadFromFile 128x128", "bytes", 0, Bench_SetupBigLevel,
+     Bench_RunLevelLoad, NULL},
+    {"Save_GetSaveList rescan", "files", 0, Bench_SetupSaves,
+     Bench_RunSaveScan, Bench_TeardownSaves},
+    {"Save_GetSaveList cached", "files", 0, Bench_SetupSaves,
+     Bench_RunSaveCached, Bench_TeardownSaves},
+};
+
+// With arguments, only benchmarks whose name contains one of them run.
+int main(int argc, char **argv)
+{
+	SetTraceLogLevel(LOG_WARNING);
+	mkdir("build", 0777);
+	mkdir(BENCH_DIR, 0777);
+	printf("%-34s %12s %12s %7s %12s\n", "benchmark", "median ns/op",
+	       "min ns/op", "rsd", "throughput");
+	int count = (int)(sizeof(benchmarks) / sizeof(benchmarks[0]));
+	for (int i = 0; i < count; i++)
+	{
+		bool selected = argc < 2;
+		for (int a = 1; a < argc && !selected; a++)
+			selected = strstr(benchmarks[i].name, argv[a]) != NULL;
+		if (!selected)
+			continue;
+		currentBenchmark = &benchmarks[i];
+		Bench_Run(&benchmarks[i]);
+	}
+	return 0;
+}
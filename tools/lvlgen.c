@@ -0,0 +1,158 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Writes seeded stress levels: "lvlgen [options] out.lvl", or
+// "lvlgen --all DIR" for every standard profile. Options start from the
+// chosen profile ("default" if none) and override it field by field.
+#include "levelgen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void Lvlgen_Usage(void)
+{
+	fprintf(stderr,
+	        "usage: lvlgen [options] out.lvl\n"
+	        "       lvlgen --all DIR\n"
+	        "  --profile NAME     start from a standard profile:");
+	for (int i = 0; i < LEVELGEN_PROFILE_COUNT; i++)
+		fprintf(stderr, " %s", LevelGen_GetProfileName(i));
+	fprintf(stderr,
+	        "\n"
+	        "  --seed N           random seed\n"
+	        "  --size WxH         size in tiles, may exceed MAX_WORLD_*\n"
+	        "  --density F        solid share of platform rows, 0-1\n"
+	        "  --spawners N       number of spawner tiles\n"
+	        "  --mix C,S,W,B      circle/spiral/wave/burst weights\n"
+	        "  --checkpoints N    checkpoints set into the floor\n"
+	        "  --cluster          put every spawner next to the player\n");
+}
+static bool Lvlgen_Write(const LevelGenOptions *options, const char *path)
+{
+	Level level;
+	if (!LevelGen_Generate(&level, options))
+	{
+		fprintf(stderr, "lvlgen: out of memory for %dx%d\n", options->width,
+		        options->height);
+		return false;
+	}
+	int spawners = 0, checkpoints = 0;
+	for (int y = 0; y < level.height; y++)
+	{
+		for (int x = 0; x < level.width; x++)
+		{
+			int tile = level.tiles[y][x];
+			spawners +=
+			    tile >= TILE_SPAWNER_CIRCLE && tile <= TILE_SPAWNER_BURST;
+			checkpoints += tile == TILE_CHECKPOINT;
+		}
+	}
+	Level_SaveToFile(&level, path);
+	printf("%s: %dx%d, seed %u, %d spawners, %d checkpoints, %d bytes\n",
+	       path, level.width, level.height, options->seed, spawners,
+	       checkpoints, GetFileLength(path));
+	if (level.width > MAX_WORLD_WIDTH || level.height > MAX_WORLD_HEIGHT)
+		printf("  larger than %dx%d: load it with a build that defines "
+		       "MAX_WORLD_WIDTH/HEIGHT\n",
+		       MAX_WORLD_WIDTH, MAX_WORLD_HEIGHT);
+	if (spawners > MAX_SPAWNERS)
+		printf("  only the first %d spawners become active\n", MAX_SPAWNERS);
+	Level_Unload(&level);
+	return true;
+}
+int main(int argc, char **argv)
+{
+	SetTraceLogLevel(LOG_WARNING);
+	LevelGenOptions options;
+	LevelGen_DefaultOptions(&options);
+	const char *output = NULL;
+	const char *allDir = NULL;
+	// A profile sets every field, so it is applied before the other flags
+	// wherever it appears on the line.
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (strcmp(argv[i], "--profile") == 0 &&
+		    !LevelGen_GetProfile(argv[i + 1], &options))
+		{
+			fprintf(stderr, "lvlgen: bad argument %s\n", argv[i]);
+			Lvlgen_Usage();
+			return 1;
+		}
+		if (argv[i][0] == '-' && strcmp(argv[i], "--cluster") != 0)
+			i++;
+	}
+	for (int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		bool ok = true;
+		if (arg[0] != '-')
+		{
+			ok = output == NULL;
+			output = arg;
+		}
+		else if (strcmp(arg, "--cluster") == 0)
+			options.clusterSpawners = true;
+		else if (i + 1 >= argc)
+			ok = false;
+		else if (strcmp(arg, "--all") == 0)
+			allDir = argv[++i];
+		else if (strcmp(arg, "--profile") == 0)
+			i++;
+		else if (strcmp(arg, "--seed") == 0)
+			options.seed = (unsigned int)strtoul(argv[++i], NULL, 0);
+		else if (strcmp(arg, "--size") == 0)
+			ok = sscanf(argv[++i], "%dx%d", &options.width,
+			            &options.height) == 2;
+		else if (strcmp(arg, "--density") == 0)
+			options.density = (float)atof(argv[++i]);
+		else if (strcmp(arg, "--spawners") == 0)
+			options.spawnerCount = atoi(argv[++i]);
+		else if (strcmp(arg, "--mix") == 0)
+			ok = sscanf(argv[++i], "%d,%d,%d,%d", &options.spawnerMix[0],
+			            &options.spawnerMix[1], &options.spawnerMix[2],
+			            &options.spawnerMix[3]) == 4;
+		else if (strcmp(arg, "--checkpoints") == 0)
+			options.checkpointCount = atoi(argv[++i]);
+		else
+			ok = false;
+		if (!ok)
+		{
+			fprintf(stderr, "lvlgen: bad argument %s\n", arg);
+			Lvlgen_Usage();
+			return 1;
+		}
+	}
+	if (allDir)
+	{
+		bool written = true;
+		for (int p = 0; p < LEVELGEN_PROFILE_COUNT; p++)
+		{
+			const char *name = LevelGen_GetProfileName(p);
+			LevelGen_GetProfile(name, &options);
+			written &=
+			    Lvlgen_Write(&options, TextFormat("%s/%s.lvl", allDir, name));
+		}
+		return written ? 0 : 1;
+	}
+	if (!output)
+	{
+		Lvlgen_Usage();
+		return 1;
+	}
+	return Lvlgen_Write(&options, output) ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Builds the asset pack read by src/pack.c:
+//
+//   mkpak assets.pak assets/levels assets/tiles assets/music ...
+//
+// Every file under the given paths is stored under its path as written,
+// with '/' separators. Layout, all integers little-endian:
+//   header  "CPAK", u32 version, u32 entry count, u32 slot count,
+//           u32 table offset, u32 names offset
+//   slots   u32 entry index per slot (0xFFFFFFFF = empty), slot count is a
+//           power of two, filled by FNV-1a hash with linear probing
+//   entries u32 name hash, u32 name offset, u32 data offset, u32 size
+//   names   NUL-terminated, offsets relative to the names block
+//   data    each file, 16-byte aligned
+#define _POSIX_C_SOURCE 200112L
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define PACK_VERSION 1
+#define MAX_ENTRIES 4096
+
+typedef struct
+{
+	char name[256];
+	unsigned int hash;
+	unsigned int nameOffset;
+	unsigned int dataOffset;
+	unsigned int size;
+} PackEntry;
+
+static PackEntry entries[MAX_ENTRIES];
+static int entryCount = 0;
+
+// Must match Pack_Hash in src/pack.c.
+static unsigned int Hash(const char *name)
+{
+	unsigned int hash = 2166136261u;
+	for (const char *c = name; *c; c++)
+	{
+		hash ^= (unsigned char)*c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+static void PutU32(FILE *f, unsigned int value)
+{
+	unsigned char b[4] = {(unsigned char)value, (unsigned char)(value >> 8),
+	                      (unsigned char)(value >> 16),
+	                      (unsigned char)(value >> 24)};
+	fwrite(b, 1, 4, f);
+}
+static void AddPath(const char *path)
+{
+	struct stat st;
+	if (stat(path, &st) != 0)
+	{
+		fprintf(stderr, "mkpak: cannot stat %s\n", path);
+		return;
+	}
+	if (S_ISDIR(st.st_mode))
+	{
+		DIR *dir = opendir(path);
+		if (!dir)
+			return;
+		struct dirent *de;
+		while ((de = readdir(dir)) != NULL)
+		{
+			if (de->d_name[0] == '.')
+				continue;
+			char child[512];
+			snprintf(child, sizeof(child), "%s/%s", path, de->d_name);
+			AddPath(child);
+		}
+		closedir(dir);
+		return;
+	}
+	if (entryCount >= MAX_ENTRIES || strlen(path) >= 256)
+	{
+		fprintf(stderr, "mkpak: skipping %s\n", path);
+		return;
+	}
+	PackEntry *e = &entries[entryCount++];
+	const char *name = path;
+	while (name[0] == '.' && name[1] == '/')
+		name += 2;
+	strcpy(e->name, name);
+	for (char *c = e->name; *c; c++)
+	{
+		if (*c == '\\')
+			*c = '/';
+	}
+	e->hash = Hash(e->name);
+	e->size = (unsigned int)st.st_size;
+}
+static int CompareEntries(const void *a, const void *b)
+{
+	return strcmp(((const PackEntry *)a)->name, ((const PackEntry *)b)->name);
+}
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "usage: mkpak <out.pak> <file or dir>...\n");
+		return 1;
+	}
+	for (int i = 2; i < argc; i++)
+		AddPath(argv[i]);
+	qsort(entries, entryCount, sizeof(PackEntry), CompareEntries);
+
+	unsigned int slotCount = 1;
+	while (slotCount < (unsigned int)entryCount * 2 + 1)
+		slotCount <<= 1;
+	unsigned int *slots = malloc(slotCount * sizeof(unsigned int));
+	if (!slots)
+		return 1;
+	memset(slots, 0xFF, slotCount * sizeof(unsigned int));
+	for (int i = 0; i < entryCount; i++)
+	{
+		unsigned int slot = entries[i].hash & (slotCount - 1);
+		while (slots[slot] != 0xFFFFFFFFu)
+			slot = (slot + 1) & (slotCount - 1);
+		slots[slot] = (unsigned int)i;
+	}
+
+	unsigned int tableOffset = 24;
+	unsigned int namesOffset = tableOffset + slotCount * 4 + entryCount * 16;
+	unsigned int namesSize = 0;
+	for (int i = 0; i < entryCount; i++)
+	{
+		entries[i].nameOffset = namesSize;
+		namesSize += (unsigned int)strlen(entries[i].name) + 1;
+	}
+	unsigned int offset = (namesOffset + namesSize + 15) & ~15u;
+	for (int i = 0; i < entryCount; i++)
+	{
+		entries[i].dataOffset = offset;
+		offset = (offset + entries[i].size + 15) & ~15u;
+	}
+
+	FILE *out = fopen(argv[1], "wb");
+	if (!out)
+	{
+		fprintf(stderr, "mkpak: cannot write %s\n", argv[1]);
+		return 1;
+	}
+	fwrite("CPAK", 1, 4, out);
+	PutU32(out, PACK_VERSION);
+	PutU32(out, (unsigned int)entryCount);
+	PutU32(out, slotCount);
+	PutU32(out, tableOffset);
+	PutU32(out, namesOffset);
+	for (unsigned int i = 0; i < slotCount; i++)
+		PutU32(out, slots[i]);
+	for (int i = 0; i < entryCount; i++)
+	{
+		PutU32(out, entries[i].hash);
+		PutU32(out, entries[i].nameOffset);
+		PutU32(out, entries[i].dataOffset);
+		PutU32(out, entries[i].size);
+	}
+	for (int i = 0; i < entryCount; i++)
+		fwrite(entries[i].name, 1, strlen(entries[i].name) + 1, out);
+	int failed = 0;
+	for (int i = 0; i < entryCount; i++)
+	{
+		while ((unsigned int)ftell(out) < entries[i].dataOffset)
+			fputc(0, out);
+		FILE *in = fopen(entries[i].name, "rb");
+		char buffer[65536];
+		size_t n;
+		size_t copied = 0;
+		while (in && (n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+		{
+			fwrite(buffer, 1, n, out);
+			copied += n;
+		}
+		if (in)
+			fclose(in);
+		if (copied != entries[i].size)
+		{
+			fprintf(stderr, "mkpak: short read on %s\n", entries[i].name);
+			failed = 1;
+		}
+	}
+	long total = ftell(out);
+	fclose(out);
+	free(slots);
+	printf("mkpak: %d files, %ld bytes -> %s\n", entryCount, total, argv[1]);
+	return failed;
+}
@@ -0,0 +1,364 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Tick-budget regression gate: "make perfgate".
+//
+// Replays a scripted run on every shipped level and on the generated
+// stress profiles at a fixed 1/TARGET_FPS step. Each tick times
+// World_Update (with item collection, as the game does) and World_Draw
+// separately. Their p50 and p99 are compared with a checked-in baseline;
+// a run fails when either grows past the tolerance, or when its p99 tick
+// takes longer than a frame. The slowest tick is only reported: a single
+// one is at the mercy of the scheduler and would make the gate flaky.
+//
+//   perfgate [--baseline FILE] [--write FILE] [--ticks N]
+//            [--tolerance F] [--no-draw] [NAME...]
+//
+// NAME arguments pick the runs whose names contain them. Exits 0 within
+// budget, 1 over budget and 2 on bad arguments. Runs from the repository
+// root. The window is hidden but still needs a display; use xvfb-run on a
+// machine without one.
+#include "atlas.h"
+#include "levelgen.h"
+#include "manifest.h"
+#include "pack.h"
+#include "render.h"
+#include "world.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PERFGATE_TICKS 1800     // 30 s of play per run
+#define PERFGATE_WARMUP 60      // first ticks, left out of the statistics
+#define PERFGATE_TOLERANCE 0.25 // allowed growth over the baseline
+#define PERFGATE_SLACK_US 10.0  // absorbs jitter on very short timings
+#define PERFGATE_MAX_ENTRIES 128
+#define PERFGATE_NAME_SIZE 72 // "level-" and a 63 character manifest name
+#define PERFGATE_BASELINE "tools/perfgate_baseline.txt"
+
+typedef struct
+{
+	char run[PERFGATE_NAME_SIZE];
+	char metric[16];
+	double p50;
+	double p99;
+} PerfgateEntry;
+
+typedef struct
+{
+	double p50;
+	double p99;
+	double max;
+} PerfgateStats;
+
+static World world;
+static PerfgateEntry baseline[PERFGATE_MAX_ENTRIES];
+static int baselineCount = 0;
+static PerfgateEntry results[PERFGATE_MAX_ENTRIES];
+static int resultCount = 0;
+static double *updateTimes = NULL;
+static double *drawTimes = NULL;
+static double *tickTimes = NULL;
+static int tickCount = PERFGATE_TICKS;
+static double tolerance = PERFGATE_TOLERANCE;
+static bool drawEnabled = true;
+static int runCount = 0;
+static int failures = 0;
+
+static void Perfgate_Usage(void)
+{
+	fprintf(stderr,
+	        "usage: perfgate [options] [NAME...]\n"
+	        "  --baseline FILE    compare with FILE (default %s)\n"
+	        "  --write FILE       write this run's numbers as a baseline\n"
+	        "  --ticks N          ticks per run (default %d)\n"
+	        "  --tolerance F      allowed growth, 0.25 = 25%% (default %.2f)\n"
+	        "  --no-draw          time World_Update only\n",
+	        PERFGATE_BASELINE, PERFGATE_TICKS, PERFGATE_TOLERANCE);
+}
+static bool Perfgate_LoadBaseline(const char *path)
+{
+	FILE *f = fopen(path, "r");
+	if (!f)
+		return false;
+	char line[256];
+	while (fgets(line, sizeof(line), f) &&
+	       baselineCount < PERFGATE_MAX_ENTRIES)
+	{
+		PerfgateEntry *e = &baseline[baselineCount];
+		if (line[0] != '#' && sscanf(line, "%71s %15s %lf %lf", e->run,
+		                             e->metric, &e->p50, &e->p99) == 4)
+			baselineCount++;
+	}
+	fclose(f);
+	return true;
+}
+static bool Perfgate_WriteBaseline(const char *path)
+{
+	FILE *f = fopen(path, "w");
+	if (!f)
+		return false;
+	fprintf(f, "# perfgate baseline: run, metric, p50 and p99 in us/tick.\n"
+	           "# Regenerate with \"perfgate --write %s\".\n",
+	        path);
+	for (int i = 0; i < resultCount; i++)
+		fprintf(f, "%-24s %-7s %9.1f %9.1f\n", results[i].run,
+		        results[i].metric, results[i].p50, results[i].p99);
+	fclose(f);
+	return true;
+}
+static int Perfgate_CompareDoubles(const void *a, const void *b)
+{
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+static PerfgateStats Perfgate_GetStats(double *samples, int count)
+{
+	PerfgateStats stats = {0};
+	if (count <= 0)
+		return stats;
+	qsort(samples, count, sizeof(double), Perfgate_CompareDoubles);
+	stats.p50 = samples[(count - 1) / 2];
+	stats.p99 = samples[(int)((count - 1) * 0.99)];
+	stats.max = samples[count - 1];
+	return stats;
+}
+static double Perfgate_Allowed(double base)
+{
+	double allowed = base * (1.0 + tolerance);
+	return allowed > base + PERFGATE_SLACK_US ? allowed
+	                                          : base + PERFGATE_SLACK_US;
+}
+// Records the numbers for --write and checks them against the baseline.
+// A run with no baseline entry yet only has to fit the tick budget.
+static bool Perfgate_Check(const char *run, const char *metric,
+                           PerfgateStats stats)
+{
+	if (resultCount < PERFGATE_MAX_ENTRIES)
+	{
+		PerfgateEntry *e = &results[resultCount++];
+		snprintf(e->run, sizeof(e->run), "%s", run);
+		snprintf(e->metric, sizeof(e->metric), "%s", metric);
+		e->p50 = stats.p50;
+		e->p99 = stats.p99;
+	}
+	for (int i = 0; i < baselineCount; i++)
+	{
+		const PerfgateEntry *b = &baseline[i];
+		if (strcmp(b->run, run) != 0 || strcmp(b->metric, metric) != 0)
+			continue;
+		if (stats.p50 <= Perfgate_Allowed(b->p50) &&
+		    stats.p99 <= Perfgate_Allowed(b->p99))
+			return true;
+		printf("  FAIL %s %s: p50 %.1f us (baseline %.1f), "
+		       "p99 %.1f us (baseline %.1f)\n",
+		       run, metric, stats.p50, b->p50, stats.p99, b->p99);
+		return false;
+	}
+	return true;
+}
+// The scripted player runs right, jumps in a steady rhythm, dashes and
+// floats now and then, and holds slow-down in bursts so parries happen.
+static PlayerInput Perfgate_Script(int tick)
+{
+	PlayerInput input = {0};
+	input.right = true;
+	input.jumpPressed = tick % 45 == 0;
+	input.up = tick % 45 < 20;
+	input.dashPressed = tick % 240 == 120;
+	input.floatPressed = tick % 600 == 330;
+	input.slowDown = tick % 300 >= 200 && tick % 300 < 230;
+	return input;
+}
+// Stands in for the game's death, fall and level-complete handling so a
+// run keeps going for all of its ticks.
+static void Perfgate_Respawn(void)
+{
+	if (World_LevelCompleted(&world))
+	{
+		Player_Init(&world.player, world.level.playerSpawn);
+	}
+	else if (!Player_IsAlive(&world.player) ||
+	         World_IsPlayerOutOfBounds(&world))
+	{
+		Player_Init(&world.player, world.player.lastCheckpoint);
+		World_ResetBullets(&world);
+	}
+}
+static void Perfgate_Run(const char *name)
+{
+	float dt = 1.0f / TARGET_FPS;
+	int samples = 0;
+	for (int tick = 0; tick < tickCount; tick++)
+	{
+		PlayerInput input = Perfgate_Script(tick);
+		int healthCollected = 0;
+		int scoreCollected = 0;
+		double start = GetTime();
+		World_Update(&world, dt, &input);
+		World_CollectItems(&world, &healthCollected, &scoreCollected);
+		double updated = GetTime();
+		double drawStart = updated;
+		double drawn = updated;
+		if (drawEnabled)
+		{
+			BeginDrawing();
+			ClearBackground(SKY_COLOR);
+			drawStart = GetTime();
+			World_Draw(&world);
+			drawn = GetTime();
+			EndDrawing();
+		}
+		Perfgate_Respawn();
+		if (tick < PERFGATE_WARMUP)
+			continue;
+		updateTimes[samples] = (updated - start) * 1e6;
+		drawTimes[samples] = (drawn - drawStart) * 1e6;
+		tickTimes[samples] = updateTimes[samples] + drawTimes[samples];
+		samples++;
+	}
+	PerfgateStats update = Perfgate_GetStats(updateTimes, samples);
+	PerfgateStats draw = Perfgate_GetStats(drawTimes, samples);
+	PerfgateStats tick = Perfgate_GetStats(tickTimes, samples);
+	printf("%-24s %8.1f %8.1f %8.1f   %8.1f %8.1f %8.1f\n", name,
+	       update.p50, update.p99, update.max, draw.p50, draw.p99, draw.max);
+	bool ok = Perfgate_Check(name, "update", update);
+	if (drawEnabled)
+		ok = Perfgate_Check(name, "draw", draw) && ok;
+	double budget = 1e6 / TARGET_FPS;
+	if (tick.p99 > budget)
+	{
+		printf("  FAIL %s: p99 tick %.1f us, budget %.1f us\n", name,
+		       tick.p99, budget);
+		ok = false;
+	}
+	runCount++;
+	if (!ok)
+		failures++;
+}
+static bool Perfgate_Selected(const char *name, int argc, char **argv,
+                              int first)
+{
+	if (first >= argc)
+		return true;
+	for (int a = first; a < argc; a++)
+		if (strstr(name, argv[a]))
+			return true;
+	return false;
+}
+int main(int argc, char **argv)
+{
+	const char *baselinePath = PERFGATE_BASELINE;
+	const char *writePath = NULL;
+	int a = 1;
+	for (; a < argc && strncmp(argv[a], "--", 2) == 0; a++)
+	{
+		bool hasValue = a + 1 < argc;
+		if (strcmp(argv[a], "--baseline") == 0 && hasValue)
+			baselinePath = argv[++a];
+		else if (strcmp(argv[a], "--write") == 0 && hasValue)
+			writePath = argv[++a];
+		else if (strcmp(argv[a], "--ticks") == 0 && hasValue)
+			tickCount = atoi(argv[++a]);
+		else if (strcmp(argv[a], "--tolerance") == 0 && hasValue)
+			tolerance = atof(argv[++a]);
+		else if (strcmp(argv[a], "--no-draw") == 0)
+			drawEnabled = false;
+		else
+		{
+			Perfgate_Usage();
+			return 2;
+		}
+	}
+	if (tickCount <= PERFGATE_WARMUP || tolerance < 0)
+	{
+		Perfgate_Usage();
+		return 2;
+	}
+	if (!writePath && !Perfgate_LoadBaseline(baselinePath))
+	{
+		fprintf(stderr, "perfgate: cannot read baseline %s\n", baselinePath);
+		return 2;
+	}
+	updateTimes = malloc(sizeof(double) * tickCount);
+	drawTimes = malloc(sizeof(double) * tickCount);
+	tickTimes = malloc(sizeof(double) * tickCount);
+	if (!updateTimes || !drawTimes || !tickTimes)
+		return 2;
+
+	SetTraceLogLevel(LOG_WARNING);
+	SetConfigFlags(FLAG_WINDOW_HIDDEN);
+	InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "perfgate");
+	Pack_Open(ASSET_PACK_PATH);
+	Manifest_Init();
+	Atlas_Build();
+	Render_Init(NULL);
+
+	printf("%d ticks per run, times in us   update p50/p99/max"
+	       "       draw p50/p99/max\n",
+	       tickCount);
+	char name[PERFGATE_NAME_SIZE];
+	for (int i = 0; i < Manifest_GetCount(); i++)
+	{
+		snprintf(name, sizeof(name), "level-%s", Manifest_GetEntry(i)->name);
+		if (!Perfgate_Selected(name, argc, argv, a))
+			continue;
+		World_Load(&world, i);
+		Perfgate_Run(name);
+		World_Unload(&world);
+	}
+	// Profiles bigger than the game allows are left to the benchmarks.
+	for (int i = 0; i < LEVELGEN_PROFILE_COUNT; i++)
+	{
+		LevelGenOptions options;
+		const char *profile = LevelGen_GetProfileName(i);
+		snprintf(name, sizeof(name), "gen-%s", profile);
+		if (!Perfgate_Selected(name, argc, argv, a) ||
+		    !LevelGen_GetProfile(profile, &options) ||
+		    options.width > MAX_WORLD_WIDTH ||
+		    options.height > MAX_WORLD_HEIGHT)
+			continue;
+		Assets_Load(&world.assets);
+		if (!LevelGen_Generate(&world.level, &options))
+		{
+			Assets_Unload(&world.assets);
+			continue;
+		}
+		World_Populate(&world);
+		Perfgate_Run(name);
+		World_Unload(&world);
+	}
+
+	Render_Unload();
+	Atlas_Unload();
+	Manifest_Shutdown();
+	Pack_Close();
+	CloseWindow();
+	free(updateTimes);
+	free(drawTimes);
+	free(tickTimes);
+	if (writePath && !Perfgate_WriteBaseline(writePath))
+	{
+		fprintf(stderr, "perfgate: cannot write %s\n", writePath);
+		return 2;
+	}
+	printf("%s: %d of %d runs over budget\n", failures ? "FAIL" : "ok",
+	       failures, runCount);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,258 @@
+/*
+ * Cirno's Hardest Platformer 2026 - A challenging 2D platformer game.
+ * Copyright (C) 2026 Aaditya Aryal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Bullet pattern sandbox: "make sandbox". Runs the real spawner.c patterns
+// with the SpawnerConfig fields on sliders, so patterns can be tuned
+// against the engine code and what it actually costs per frame.
+//
+// The arena on the left is one game screen with a stand-in player at its
+// centre, so bullets despawn exactly where they would in the game. The
+// Makefile builds this against its own copy of the game objects with a
+// much larger MAX_BULLETS.
+#include "atlas.h"
+#include "pack.h"
+#include "renderqueue.h"
+#include "spawner.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "raygui.h"
+
+#define SANDBOX_PANEL_WIDTH 320
+#define SANDBOX_MAX_SPAWNERS 64
+#define SANDBOX_AVERAGE_FRAMES 30
+#define SANDBOX_SLIDER_X (SCREEN_WIDTH + 110)
+#define SANDBOX_SLIDER_WIDTH 150
+
+typedef enum
+{
+	SANDBOX_EMIT,
+	SANDBOX_UPDATE,
+	SANDBOX_DRAW,
+	SANDBOX_FLUSH,
+	SANDBOX_STAGE_COUNT
+} SandboxStage;
+
+static const char *stageNames[SANDBOX_STAGE_COUNT] = {"Emit", "Update",
+                                                      "Draw", "Flush"};
+static const Color stageColors[SANDBOX_STAGE_COUNT] = {ORANGE, SKYBLUE, LIME,
+                                                       VIOLET};
+
+static Bullet bullets[MAX_BULLETS];
+static int bulletCount = 0;
+static Collectible collectibles[MAX_COLLECTIBLES];
+static int collectibleCount = 0;
+static BulletSpawner spawners[SANDBOX_MAX_SPAWNERS];
+static int spawnerCount = 1;
+static int pattern = SPAWNER_PATTERN_CIRCLE;
+static SpawnerConfig config;
+static Player player;
+static bool paused = false;
+
+// Per-stage milliseconds, the last SANDBOX_AVERAGE_FRAMES of them.
+static double stageHistory[SANDBOX_STAGE_COUNT][SANDBOX_AVERAGE_FRAMES];
+static int historyIndex = 0;
+static int emittedThisFrame = 0;
+static int peakBullets = 0;
+
+// Lays the spawners out on a grid filling the arena.
+static void Sandbox_PlaceSpawners(void)
+{
+	int columns = (int)ceilf(sqrtf((float)spawnerCount));
+	int rows = (spawnerCount + columns - 1) / columns;
+	for (int i = 0; i < spawnerCount; i++)
+	{
+		float x = (float)SCREEN_WIDTH * (i % columns + 1) / (columns + 1);
+		float y = (float)SCREEN_HEIGHT * (i / columns + 1) / (rows + 1);
+		spawners[i].position = (Vector2){x - TILE_SIZE / 2, y - TILE_SIZE / 2};
+	}
+}
+// Pushes the sliders into every spawner without restarting its timer or
+// rotation, so changes show up mid-pattern.
+static void Sandbox_ApplyConfig(void)
+{
+	for (int i = 0; i < spawnerCount; i++)
+	{
+		BulletSpawner *s = &spawners[i];
+		float timer = s->timer;
+		float angleOffset = s->angleOffset;
+		unsigned int rng = s->rng;
+		Spawner_InitWithConfig(s, s->position, (SpawnerPattern)pattern, config);
+		s->timer = timer < s->cooldown ? timer : 0;
+		s->angleOffset = angleOffset;
+		s->rng = rng;
+	}
+}
+static void Sandbox_Slider(int *y, const char *label, float *value, float min,
+                           float max, const char *format)
+{
+	GuiLabel((Rectangle){SCREEN_WIDTH + 10, *y, 100, 20}, label);
+	GuiSliderBar((Rectangle){SANDBOX_SLIDER_X, *y, SANDBOX_SLIDER_WIDTH, 20},
+	             NULL, TextFormat(format, *value), value, min, max);
+	*y += 26;
+}
+static void Sandbox_DrawPanel(void)
+{
+	int x = SCREEN_WIDTH + 10;
+	int y = 10;
+	DrawRectangle(SCREEN_WIDTH, 0, SANDBOX_PANEL_WIDTH, SCREEN_HEIGHT,
+	              (Color){30, 30, 40, 255});
+	int previousPattern = pattern;
+	GuiToggleGroup((Rectangle){x, y, 58, 24},
+	               "Circle;Spiral;Wave;Burst;Target", &pattern);
+	if (pattern != previousPattern)
+		config = Spawner_GetDefaultConfig((SpawnerPattern)pattern);
+	y += 34;
+
+	float spawnersValue = (float)spawnerCount;
+	float countValue = (float)config.bulletCount;
+	float sizeValue = config.bulletSize;
+	Sandbox_Slider(&y, "Spawners", &spawnersValue, 1, SANDBOX_MAX_SPAWNERS,
+	               "%.0f");
+	Sandbox_Slider(&y, "Cooldown", &config.cooldown, 0.01f, 2.0f, "%.2f s");
+	Sandbox_Slider(&y, "Bullets", &countValue, 2, 256, "%.0f");
+	Sandbox_Slider(&y, "Speed", &config.bulletSpeed, 10, 600, "%.0f");
+	Sandbox_Slider(&y, "Spread", &config.spreadAngle, 0, 360, "%.0f deg");
+	Sandbox_Slider(&y, "Rotation", &config.rotationSpeed, -720, 720,
+	               "%.0f deg/s");
+	Sandbox_Slider(&y, "Variation", &config.speedVariation, 0, 200, "%.0f");
+	Sandbox_Slider(&y, "Size", &sizeValue, 1, 20, "%.1f");
+	GuiCheckBox((Rectangle){x, y, 20, 20}, "Randomize speed",
+	            &config.randomizeSpeed);
+	y += 30;
+	config.bulletCount = (int)countValue;
+	config.bulletSize = sizeValue;
+	if ((int)spawnersValue != spawnerCount)
+	{
+		spawnerCount = (int)spawnersValue;
+		Sandbox_PlaceSpawners();
+	}
+	if (GuiButton((Rectangle){x, y, 95, 24}, "Defaults"))
+		config = Spawner_GetDefaultConfig((SpawnerPattern)pattern);
+	if (GuiButton((Rectangle){x + 100, y, 95, 24}, "Clear"))
+		bulletCount = 0;
+	if (GuiButton((Rectangle){x + 200, y, 95, 24}, paused ? "Resume" : "Pause"))
+		paused = !paused;
+	y += 40;
+
+	// Timings: averages as numbers, the current frame as a stacked bar
+	// against the 60 FPS budget.
+	double total = 0.0;
+	float barX = (float)x;
+	float barScale =
+	    (SANDBOX_PANEL_WIDTH - 20) / (RENDER_FRAME_BUDGET * 1000.0f);
+	for (int s = 0; s < SANDBOX_STAGE_COUNT; s++)
+	{
+		double average = 0.0;
+		for (int i = 0; i < SANDBOX_AVERAGE_FRAMES; i++)
+			average += stageHistory[s][i];
+		average /= SANDBOX_AVERAGE_FRAMES;
+		total += average;
+		DrawRectangle(x, y + 4, 10, 10, stageColors[s]);
+		DrawText(TextFormat("%-7s %7.3f ms", stageNames[s], average), x + 16, y,
+		         18, RAYWHITE);
+		y += 22;
+		int last = (historyIndex + SANDBOX_AVERAGE_FRAMES - 1) %
+		           SANDBOX_AVERAGE_FRAMES;
+		float width = (float)stageHistory[s][last] * barScale;
+		DrawRectangleRec((Rectangle){barX, SCREEN_HEIGHT - 30, width, 16},
+		                 stageColors[s]);
+		barX += width;
+	}
+	DrawRectangleLines(x, SCREEN_HEIGHT - 30, SANDBOX_PANEL_WIDTH - 20, 16,
+	                   GRAY);
+	DrawText(TextFormat("Total   %7.3f ms", total), x + 16, y, 18, YELLOW);
+	y += 30;
+	DrawText(TextFormat("Bullets %d / %d", bulletCount, MAX_BULLETS), x, y, 18,
+	         RAYWHITE);
+	y += 22;
+	DrawText(TextFormat("Peak %d, emitted %d", peakBullets, emittedThisFrame),
+	         x, y, 18, RAYWHITE);
+	y += 22;
+	DrawText(TextFormat("%d FPS, %d batches", GetFPS(),
+	                    RenderQueue_GetLastBatchCount()),
+	         x, y, 18, RAYWHITE);
+	DrawText("frame budget", x, SCREEN_HEIGHT - 50, 14, GRAY);
+}
+int main(void)
+{
+	SetTraceLogLevel(LOG_WARNING);
+	InitWindow(SCREEN_WIDTH + SANDBOX_PANEL_WIDTH, SCREEN_HEIGHT,
+	           "Cirno bullet sandbox");
+	SetTargetFPS(TARGET_FPS);
+	Pack_Open(ASSET_PACK_PATH);
+	Atlas_Build();
+	// The stand-in player sits in the middle of the arena and never moves;
+	// Bullet_Update uses it for the despawn bounds.
+	Player_Init(&player, (Vector2){(SCREEN_WIDTH - PLAYER_SIZE) / 2.0f,
+	                               (SCREEN_HEIGHT - PLAYER_SIZE) / 2.0f});
+	config = Spawner_GetDefaultConfig((SpawnerPattern)pattern);
+	for (int i = 0; i < SANDBOX_MAX_SPAWNERS; i++)
+		Spawner_InitWithConfig(&spawners[i], (Vector2){0, 0},
+		                       (SpawnerPattern)pattern, config);
+	Sandbox_PlaceSpawners();
+	while (!WindowShouldClose())
+	{
+		if (IsKeyPressed(KEY_SPACE))
+			paused = !paused;
+		float dt = paused ? 0.0f : GetFrameTime();
+		Vector2 mouse = GetMousePosition();
+		Vector2 center = {SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+		Vector2 target = mouse.x < SCREEN_WIDTH ? mouse : center;
+		Sandbox_ApplyConfig();
+		double stage[SANDBOX_STAGE_COUNT];
+
+		double start = GetTime();
+		int before = bulletCount;
+		for (int i = 0; i < spawnerCount; i++)
+			Spawner_Update(&spawners[i], bullets, &bulletCount, collectibles,
+			               &collectibleCount, target, dt);
+		collectibleCount = 0;
+		emittedThisFrame = bulletCount - before;
+		stage[SANDBOX_EMIT] = GetTime();
+		Bullet_Update(bullets, &bulletCount, &player, dt);
+		if (bulletCount > peakBullets)
+			peakBullets = bulletCount;
+		stage[SANDBOX_UPDATE] = GetTime();
+
+		BeginDrawing();
+		ClearBackground(SKY_COLOR);
+		BeginScissorMode(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+		double drawStart = GetTime();
+		for (int i = 0; i < spawnerCount; i++)
+			Spawner_Draw(&spawners[i]);
+		Bullet_Draw(bullets, bulletCount);
+		stage[SANDBOX_DRAW] = GetTime();
+		RenderQueue_Flush();
+		stage[SANDBOX_FLUSH] = GetTime();
+		EndScissorMode();
+		DrawCircleV(target, 4, WHITE);
+		Sandbox_DrawPanel();
+		EndDrawing();
+
+		double previous[SANDBOX_STAGE_COUNT] = {start, stage[SANDBOX_EMIT],
+		                                        drawStart, stage[SANDBOX_DRAW]};
+		for (int s = 0; s < SANDBOX_STAGE_COUNT; s++)
+			stageHistory[s][historyIndex] = (stage[s] - previous[s]) * 1000.0;
+		historyIndex = (historyIndex + 1) % SANDBOX_AVERAGE_FRAMES;
+	}
+	Atlas_Unload();
+	Pack_Close();
+	CloseWindow();
+	return 0;
+}